@@ -0,0 +1,100 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Little-endian helpers shared by the binary output formats
+ *
+ * Put* functions append to a byte vector; Get* functions read from a cursor
+ * and advance it, returning false instead of reading past `end`.
+ */
+
+inline void PutU32(std::vector<uint8_t> &out, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+inline void PutU64(std::vector<uint8_t> &out, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+inline void PutF64(std::vector<uint8_t> &out, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  PutU64(out, bits);
+}
+
+inline void PutBytes(std::vector<uint8_t> &out, const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+inline bool GetU32(const uint8_t *&in, const uint8_t *end, uint32_t &value) {
+  if (end - in < 4)
+    return false;
+  value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= static_cast<uint32_t>(in[i]) << (8 * i);
+  }
+  in += 4;
+  return true;
+}
+
+inline bool GetU64(const uint8_t *&in, const uint8_t *end, uint64_t &value) {
+  if (end - in < 8)
+    return false;
+  value = 0;
+  for (int i = 0; i < 8; i++) {
+    value |= static_cast<uint64_t>(in[i]) << (8 * i);
+  }
+  in += 8;
+  return true;
+}
+
+inline bool GetF64(const uint8_t *&in, const uint8_t *end, double &value) {
+  uint64_t bits;
+  if (!GetU64(in, end, bits))
+    return false;
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+inline bool GetBytes(const uint8_t *&in, const uint8_t *end, void *data, size_t size) {
+  if (static_cast<size_t>(end - in) < size)
+    return false;
+  std::memcpy(data, in, size);
+  in += size;
+  return true;
+}
+
+/**
+ * @brief Read a whole file into memory
+ * @return False if the file cannot be opened
+ */
+inline bool ReadFileBytes(const std::string &filename, std::vector<uint8_t> &data) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+  data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+/**
+ * @brief Write a byte vector to a file, replacing it
+ * @return False if the file cannot be written
+ */
+inline bool WriteFileBytes(const std::string &filename, const std::vector<uint8_t> &data) {
+  std::ofstream file(filename, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+  return static_cast<bool>(file);
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef BITPLANE_H
+#define BITPLANE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Packed one-bit-per-cell plane stored in 64-bit words
+ *
+ * Whole-plane operations (counting, scanning, combining planes) work a
+ * word at a time with simple loops the compiler vectorizes, so scanning a
+ * million-cell grid touches 16K words instead of a million bytes.  Bits past
+ * GetSize() in the last word are always kept zero.
+ */
+class Bitplane {
+private:
+  std::vector<uint64_t> words;
+  size_t num_bits = 0;
+
+public:
+  /**
+   * @brief Resize the plane, keeping existing bits and clearing new ones
+   * @param bits Number of cells
+   */
+  void Resize(size_t bits) {
+    num_bits = bits;
+    words.resize((bits + 63) / 64, 0);
+    ClearTail();
+  }
+
+  size_t GetSize() const { return num_bits; }
+  size_t GetNumWords() const { return words.size(); }
+  const uint64_t *GetWords() const { return words.data(); }
+  uint64_t *GetWords() { return words.data(); }
+
+  bool Get(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+  void Set(size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+  void Clear(size_t i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+  void Set(size_t i, bool value) {
+    if (value)
+      Set(i);
+    else
+      Clear(i);
+  }
+
+  /**
+   * @brief Clear every bit
+   */
+  void ClearAll() { std::fill(words.begin(), words.end(), 0); }
+
+  /**
+   * @brief Count set bits
+   */
+  size_t Count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+      total += __builtin_popcountll(word);
+    }
+    return total;
+  }
+
+  /**
+   * @brief Call fn(i) for every set bit, in increasing order
+   */
+  template <typename FUN> void ForEachSet(FUN fn) const {
+    for (size_t w = 0; w < words.size(); w++) {
+      ForEachBit(words[w], w, fn);
+    }
+  }
+
+  /**
+   * @brief Call fn(i) for every clear bit, in increasing order
+   */
+  template <typename FUN> void ForEachClear(FUN fn) const {
+    for (size_t w = 0; w < words.size(); w++) {
+      ForEachBit(~words[w] & TailMask(w), w, fn);
+    }
+  }
+
+private:
+  /**
+   * @brief Mask of the valid bits of word w
+   */
+  uint64_t TailMask(size_t w) const {
+    size_t tail_bits = num_bits & 63;
+    return (w + 1 == words.size() && tail_bits) ? (uint64_t(1) << tail_bits) - 1
+                                                : ~uint64_t(0);
+  }
+
+  /**
+   * @brief Zero the unused bits of the last word
+   */
+  void ClearTail() {
+    if (!words.empty()) {
+      words.back() &= TailMask(words.size() - 1);
+    }
+  }
+
+  template <typename FUN>
+  static void ForEachBit(uint64_t bits, size_t w, FUN &fn) {
+    while (bits) {
+      fn(w * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+};
+
+#endif
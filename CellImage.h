@@ -0,0 +1,165 @@
+#ifndef CELL_IMAGE_H
+#define CELL_IMAGE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Bitplane.h"
+
+/**
+ * @brief RGBA image of an OrgWorld grid, one pixel per cell
+ *
+ * The image is rebuilt from the world's bitplanes.  The planes of the last
+ * Update are kept, so a word of 64 cells whose destroyed, occupied and
+ * species-C bits are all unchanged costs three comparisons, and only the
+ * cells that changed are written.  The rows touched since the last
+ * ClearDirty are reported, so a viewer uploads just that band of the
+ * buffer.
+ *
+ * Pixels are stored as R, G, B, A bytes, the layout of an HTML ImageData.
+ */
+class CellImage {
+public:
+  /**
+   * @brief Colour of each kind of cell
+   */
+  enum Paint { EMPTY_PAINT = 0, DESTROYED_PAINT, SPECIES_C_PAINT, SPECIES_D_PAINT };
+
+private:
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels; ///< One RGBA pixel per cell, bytes in memory order
+  std::array<uint32_t, 4> palette = {Pack(0, 128, 0), Pack(0, 0, 0), Pack(0, 0, 255),
+                                     Pack(255, 165, 0)}; ///< green, black, blue, orange
+  std::vector<uint64_t> last_destroyed; ///< Planes at the last Update
+  std::vector<uint64_t> last_occupied;
+  std::vector<uint64_t> last_species_c;
+  bool redraw_all = true;     ///< Next Update writes every pixel
+  size_t dirty_first = SIZE_MAX; ///< First cell written since ClearDirty
+  size_t dirty_last = 0;         ///< Last cell written since ClearDirty
+
+public:
+  /**
+   * @brief Set the grid size; the next Update redraws every cell
+   */
+  void Resize(int _width, int _height) {
+    width = _width;
+    height = _height;
+    pixels.assign(static_cast<size_t>(width) * height, palette[EMPTY_PAINT]);
+    const size_t num_words = (pixels.size() + 63) / 64;
+    last_destroyed.assign(num_words, 0);
+    last_occupied.assign(num_words, 0);
+    last_species_c.assign(num_words, 0);
+    redraw_all = true;
+  }
+
+  /**
+   * @brief Change the colour of a kind of cell
+   */
+  void SetColor(Paint paint, uint8_t red, uint8_t green, uint8_t blue) {
+    palette[paint] = Pack(red, green, blue);
+    redraw_all = true;
+  }
+
+  int GetWidth() const { return width; }
+  int GetHeight() const { return height; }
+
+  /**
+   * @brief Get the pixels: width * height * 4 bytes, row by row
+   */
+  const uint8_t *GetData() const {
+    return reinterpret_cast<const uint8_t *>(pixels.data());
+  }
+
+  /**
+   * @brief Bring the image up to date with a world
+   * @param world OrgWorld of the size given to Resize
+   * @return Number of cells whose colour was written
+   */
+  template <typename WORLD> size_t Update(const WORLD &world) {
+    return Update(world.GetDestroyedPlane(), world.GetOccupiedPlane(),
+                  world.GetSpeciesCPlane());
+  }
+
+  /**
+   * @brief Bring the image up to date with a world's bitplanes
+   * @param destroyed Destroyed cells
+   * @param occupied Occupied cells
+   * @param species_c Occupied cells holding species C
+   * @return Number of cells whose colour was written
+   */
+  size_t Update(const Bitplane &destroyed, const Bitplane &occupied,
+                const Bitplane &species_c) {
+    const uint64_t *destroyed_words = destroyed.GetWords();
+    const uint64_t *occupied_words = occupied.GetWords();
+    const uint64_t *species_c_words = species_c.GetWords();
+    size_t written = 0;
+    for (size_t w = 0; w < last_destroyed.size(); w++) {
+      uint64_t changed = (destroyed_words[w] ^ last_destroyed[w]) |
+                         (occupied_words[w] ^ last_occupied[w]) |
+                         (species_c_words[w] ^ last_species_c[w]);
+      if (redraw_all)
+        changed = ~uint64_t(0);
+      if (!changed)
+        continue;
+      for (; changed; changed &= changed - 1) {
+        const size_t bit = __builtin_ctzll(changed);
+        const size_t pos = w * 64 + bit;
+        if (pos >= pixels.size())
+          break;
+        Paint paint = EMPTY_PAINT;
+        if ((destroyed_words[w] >> bit) & 1) {
+          paint = DESTROYED_PAINT;
+        } else if ((occupied_words[w] >> bit) & 1) {
+          paint = ((species_c_words[w] >> bit) & 1) ? SPECIES_C_PAINT : SPECIES_D_PAINT;
+        }
+        pixels[pos] = palette[paint];
+        dirty_first = std::min(dirty_first, pos);
+        dirty_last = std::max(dirty_last, pos);
+        written++;
+      }
+      last_destroyed[w] = destroyed_words[w];
+      last_occupied[w] = occupied_words[w];
+      last_species_c[w] = species_c_words[w];
+    }
+    redraw_all = false;
+    return written;
+  }
+
+  /**
+   * @brief Get the band of rows written since ClearDirty
+   * @param first_row Set to the first row to upload
+   * @param num_rows Set to the number of rows (0 if nothing changed)
+   */
+  void GetDirtyRows(int &first_row, int &num_rows) const {
+    if (dirty_first > dirty_last) {
+      first_row = 0;
+      num_rows = 0;
+      return;
+    }
+    first_row = static_cast<int>(dirty_first / width);
+    num_rows = static_cast<int>(dirty_last / width) - first_row + 1;
+  }
+
+  /**
+   * @brief Mark the image as uploaded
+   */
+  void ClearDirty() {
+    dirty_first = SIZE_MAX;
+    dirty_last = 0;
+  }
+
+private:
+  /**
+   * @brief Pack a colour so its bytes lie in memory as R, G, B, A
+   *        (wasm and x86 are little-endian)
+   */
+  static constexpr uint32_t Pack(uint8_t red, uint8_t green, uint8_t blue) {
+    return uint32_t(red) | uint32_t(green) << 8 | uint32_t(blue) << 16 | 0xFF000000u;
+  }
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "emp/math/Random.hpp"
+
+#include "BinaryIO.h"
+#include "CompactWorld.h"
+#include "GillespieWorld.h"
+#include "SpeciesC.h"
+#include "SpeciesD.h"
+#include "World.h"
+
+/**
+ * @brief Binary snapshots of a running world
+ *
+ * A checkpoint holds everything that determines how a run continues: grid
+ * shape and neighbourhood, every cell's state, the destruction schedule
+ * (order, rounds and rounds processed), the event counters, the number of
+ * updates completed and the state of the emp::Random driving the run.
+ * The update count is also restored as the world's ecology update count,
+ * which keys the counter-based and per-tile random streams.  Loading a
+ * checkpoint and continuing is therefore bit-exact with never having
+ * stopped.
+ *
+ * Cells are stored as 2-bit CellState codes, four per byte.  The format is
+ * the same for every engine, so a checkpoint saved from an OrgWorld can be
+ * loaded into a CompactWorld or GillespieWorld and vice versa.  The
+ * continuous clock of a GillespieWorld is not saved; it restarts at 0.
+ *
+ * Layout (little-endian): "DYCK", uint32 version, int32 width, int32 height,
+ * uint32 neighbourhood, uint32 wrap, int32 update, uint64 extinctions,
+ * uint64 colonizations, uint64 RNG seed, uint64 RNG value, uint64 RNG Weyl
+ * state, uint64 bits of the RNG's cached exponential deviate, int32 total
+ * rounds, int32 round, uint32 order size and uint32 per scheduled cell,
+ * packed cells.
+ */
+namespace CheckpointFormat {
+constexpr char MAGIC[4] = {'D', 'Y', 'C', 'K'};
+constexpr uint32_t VERSION = 2;
+
+/**
+ * @brief Field-by-field access to the state of an emp::Random
+ *
+ * emp::Random has no public way to restore its state, so its protected
+ * fields are reached through member pointers formed in this derived class.
+ * If Empirical renames or drops a field this fails to compile instead of
+ * writing a checkpoint that no longer matches the generator.
+ */
+struct RandomState : emp::Random {
+  /** @brief Append the seed, value, Weyl state and cached deviate */
+  static void Save(std::vector<uint8_t> &data, const emp::Random &random) {
+    PutU64(data, static_cast<uint64_t>(random.*(&RandomState::original_seed)));
+    PutU64(data, static_cast<uint64_t>(random.*(&RandomState::value)));
+    PutU64(data, static_cast<uint64_t>(random.*(&RandomState::weyl_state)));
+    uint64_t exp_bits;
+    std::memcpy(&exp_bits, &(random.*(&RandomState::expRV)), sizeof(exp_bits));
+    PutU64(data, exp_bits);
+  }
+
+  /** @brief Read the fields written by Save; false if the data is truncated */
+  static bool Load(const uint8_t *&in, const uint8_t *end, emp::Random &random) {
+    uint64_t seed, value, weyl_state, exp_bits;
+    if (!GetU64(in, end, seed) || !GetU64(in, end, value) ||
+        !GetU64(in, end, weyl_state) || !GetU64(in, end, exp_bits))
+      return false;
+    Assign(random.*(&RandomState::original_seed), seed);
+    Assign(random.*(&RandomState::value), value);
+    Assign(random.*(&RandomState::weyl_state), weyl_state);
+    std::memcpy(&(random.*(&RandomState::expRV)), &exp_bits, sizeof(exp_bits));
+    return true;
+  }
+
+private:
+  template <typename T> static void Assign(T &field, uint64_t bits) {
+    field = static_cast<T>(bits);
+  }
+};
+
+inline CellState GetCell(const CompactWorld &world, size_t pos) {
+  return world.GetState(pos);
+}
+
+inline CellState GetCell(const GillespieWorld &world, size_t pos) {
+  return world.GetState(pos);
+}
+
+inline CellState GetCell(const OrgWorld &world, size_t pos) {
+  if (world.IsDestroyed(pos))
+    return DESTROYED;
+  if (!world.GetOccupiedPlane().Get(pos))
+    return EMPTY;
+  return world.GetSpecies(pos) == 0 ? SPECIES_C : SPECIES_D;
+}
+
+inline void SetCell(CompactWorld &world, emp::Random &, size_t pos, CellState state) {
+  if (state == DESTROYED)
+    world.DestroyCell(pos);
+  else if (state != EMPTY)
+    world.AddOrgAt(state - SPECIES_C, pos);
+}
+
+inline void SetCell(GillespieWorld &world, emp::Random &, size_t pos, CellState state) {
+  if (state == DESTROYED)
+    world.DestroyCell(pos);
+  else if (state != EMPTY)
+    world.AddOrgAt(state - SPECIES_C, pos);
+}
+
+inline void SetCell(OrgWorld &world, emp::Random &random, size_t pos, CellState state) {
+  if (state == DESTROYED)
+    world.DestroyCell(pos);
+  else if (state == SPECIES_C)
+    world.AddOrgAt(emp::Ptr<Organism>(new SpeciesC(&random)), pos);
+  else if (state == SPECIES_D)
+    world.AddOrgAt(emp::Ptr<Organism>(new SpeciesD(&random)), pos);
+}
+} // namespace CheckpointFormat
+
+/**
+ * @brief Serialize a world and its random number generator
+ * @param world OrgWorld, CompactWorld or GillespieWorld to save
+ * @param random Random number generator driving the world
+ * @param update Number of updates completed so far
+ * @return Checkpoint bytes
+ */
+template <typename WORLD>
+std::vector<uint8_t> SaveCheckpoint(const WORLD &world, const emp::Random &random,
+                                    int update) {
+  using namespace CheckpointFormat;
+  const DestructionSchedule &schedule = world.GetDestructionSchedule();
+  const size_t num_cells = world.GetSize();
+
+  std::vector<uint8_t> data(MAGIC, MAGIC + 4);
+  data.reserve(80 + 4 * schedule.GetOrder().size() +
+               num_cells / 4);
+  PutU32(data, VERSION);
+  PutU32(data, static_cast<uint32_t>(world.GetWidth()));
+  PutU32(data, static_cast<uint32_t>(world.GetHeight()));
+  PutU32(data, static_cast<uint32_t>(world.GetNeighborhoodType()));
+  PutU32(data, world.GetWrapEdges() ? 1 : 0);
+  PutU32(data, static_cast<uint32_t>(update));
+  PutU64(data, world.GetExtinctionEvents());
+  PutU64(data, world.GetColonizationEvents());
+
+  RandomState::Save(data, random);
+
+  PutU32(data, static_cast<uint32_t>(schedule.GetTotalRounds()));
+  PutU32(data, static_cast<uint32_t>(schedule.GetRound()));
+  PutU32(data, static_cast<uint32_t>(schedule.GetOrder().size()));
+  for (size_t pos : schedule.GetOrder()) {
+    PutU32(data, static_cast<uint32_t>(pos));
+  }
+
+  uint8_t packed = 0;
+  for (size_t pos = 0; pos < num_cells; pos++) {
+    packed |= static_cast<uint8_t>(GetCell(world, pos) << (2 * (pos & 3)));
+    if ((pos & 3) == 3 || pos + 1 == num_cells) {
+      data.push_back(packed);
+      packed = 0;
+    }
+  }
+  return data;
+}
+
+/**
+ * @brief Restore a world and its random number generator from a checkpoint
+ * @param world Any engine to overwrite; its grid is rebuilt
+ * @param random Random number generator driving the world; its state is replaced
+ * @param data Bytes produced by SaveCheckpoint
+ * @param update Set to the number of updates completed when it was saved
+ * @param error Set to a description of the problem on failure
+ * @return False if the data is not a valid checkpoint (the world is then unspecified)
+ */
+template <typename WORLD>
+bool LoadCheckpoint(WORLD &world, emp::Random &random, const std::vector<uint8_t> &data,
+                    int &update, std::string &error) {
+  using namespace CheckpointFormat;
+  const uint8_t *in = data.data();
+  const uint8_t *end = data.data() + data.size();
+
+  uint32_t version, width, height, neighborhood, wrap, saved_update;
+  uint64_t extinctions, colonizations;
+  if (data.size() < 4 || std::memcmp(in, MAGIC, 4) != 0) {
+    error = "Not a checkpoint";
+    return false;
+  }
+  in += 4;
+  if (!GetU32(in, end, version) || version != VERSION) {
+    error = "Unsupported checkpoint version";
+    return false;
+  }
+  if (!GetU32(in, end, width) || !GetU32(in, end, height) ||
+      !GetU32(in, end, neighborhood) || !GetU32(in, end, wrap) ||
+      !GetU32(in, end, saved_update) || !GetU64(in, end, extinctions) ||
+      !GetU64(in, end, colonizations)) {
+    error = "Truncated checkpoint header";
+    return false;
+  }
+  emp::Random saved_random;
+  if (!RandomState::Load(in, end, saved_random)) {
+    error = "Truncated checkpoint random state";
+    return false;
+  }
+
+  uint32_t total_rounds, round, order_size;
+  const size_t num_cells = static_cast<size_t>(width) * height;
+  if (!GetU32(in, end, total_rounds) || !GetU32(in, end, round) ||
+      !GetU32(in, end, order_size) || order_size > num_cells) {
+    error = "Invalid checkpoint destruction schedule";
+    return false;
+  }
+  emp::vector<size_t> order(order_size);
+  for (size_t &pos : order) {
+    uint32_t value;
+    if (!GetU32(in, end, value) || value >= num_cells) {
+      error = "Invalid checkpoint destruction schedule";
+      return false;
+    }
+    pos = value;
+  }
+  if (static_cast<size_t>(end - in) != (num_cells + 3) / 4) {
+    error = "Checkpoint cell data has the wrong size";
+    return false;
+  }
+
+  world.SetNeighborhood(static_cast<NeighborhoodType>(neighborhood), wrap != 0);
+  world.InitializeGrid(static_cast<int>(width), static_cast<int>(height));
+  world.ClearGrid();
+  for (size_t pos = 0; pos < num_cells; pos++) {
+    CellState state = static_cast<CellState>((in[pos >> 2] >> (2 * (pos & 3))) & 3);
+    SetCell(world, random, pos, state);
+  }
+  world.RestoreDestructionSchedule(std::move(order), static_cast<int>(total_rounds),
+                                   static_cast<int>(round));
+  world.SetEventCounts(extinctions, colonizations);
+  world.SetEcologyUpdates(saved_update);
+
+  random = saved_random;
+  update = static_cast<int>(saved_update);
+  return true;
+}
+
+#endif
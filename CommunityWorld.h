@@ -0,0 +1,410 @@
+#ifndef COMMUNITY_WORLD_H
+#define COMMUNITY_WORLD_H
+
+#include "emp/math/Random.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CompactWorld.h"
+#include "CounterRNG.h"
+#include "SpeciesTraits.h"
+
+/**
+ * @brief Species rates and competition matrix of an N-species community
+ */
+struct CommunitySpec {
+  /// Rates of each species, indexed by species id
+  std::vector<SpeciesParams> species;
+  /// Row-major N x N; displaces[i * N + j] is 1 if species i displaces species j
+  std::vector<uint8_t> displaces;
+
+  size_t GetNumSpecies() const { return species.size(); }
+
+  /**
+   * @brief Set a strict competitive hierarchy: species i displaces every j > i
+   *
+   * Tilman's competition-colonization trade-off when the colonization
+   * rates increase with the species id.
+   */
+  void SetHierarchy() {
+    const size_t n = species.size();
+    displaces.assign(n * n, 0);
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = i + 1; j < n; j++) {
+        displaces[i * n + j] = 1;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Discrete-update engine for communities of up to MAX_SPECIES species
+ *
+ * Same asynchronous extinction/colonization dynamics as CompactWorld, with
+ * the species, their rates and who displaces whom read from a CommunitySpec
+ * at run time.  Grid state, habitat destruction and the neighbourhood are
+ * kept in a CompactWorld whose state bytes hold SPECIES_C + species id, as
+ * in GillespieWorld.  The kernel indexes two small tables by the raw cell
+ * byte: the colonizer's rates, and a 256-bit mask of the states it can
+ * enter (the competition matrix as bits, 32 bytes per species), so target
+ * selection is one bit test per neighbour however many species there are.
+ *
+ * Random numbers are drawn in the same order as CompactWorld's asynchronous
+ * mode, so the two-species hierarchy with rates 0.2/0.5 and 0.1 gives the
+ * same results as CompactWorld run for run.
+ */
+class CommunityWorld {
+public:
+  /// Species ids 0..MAX_SPECIES-1 fit the state byte after EMPTY and DESTROYED
+  static constexpr size_t MAX_SPECIES = 256 - SPECIES_C;
+
+private:
+  static constexpr size_t MASK_WORDS = 4; ///< 64-bit words of one 256-state mask
+
+  emp::Random &random;
+  CompactWorld grid; ///< Cell states, neighbourhood and destruction schedule
+
+  size_t num_species = 0;
+  std::vector<SpeciesParams> state_params; ///< Rates indexed by cell state
+  std::vector<uint64_t> open_states; ///< MASK_WORDS per state: states it can colonize
+
+  // Event counters, cumulative since InitializeGrid
+  uint64_t extinction_events = 0;   ///< Organisms lost to local extinction
+  uint64_t colonization_events = 0; ///< Successful colonizations
+
+  // Random streams of the ecology updates
+  RngMode rng_mode = RngMode::SHARED;
+  CounterRNG counter_rng;        ///< Used in RngMode::COUNTER
+  uint64_t ecology_updates = 0;  ///< Updates completed since InitializeGrid (draw key)
+
+public:
+  /**
+   * @brief Construct a new CommunityWorld with the two-species model
+   * @param _random Reference to random number generator
+   */
+  CommunityWorld(emp::Random &_random) : random(_random), grid(_random) {
+    CommunitySpec spec;
+    for (const SpeciesParams &params : CompetitionColonization::PARAMS) {
+      spec.species.push_back(params);
+    }
+    spec.SetHierarchy();
+    SetCommunity(spec);
+  }
+
+  /**
+   * @brief Set the species of the community
+   * @param spec Rates and competition matrix; at most MAX_SPECIES species
+   *
+   * Existing organisms keep their species ids.
+   */
+  void SetCommunity(const CommunitySpec &spec) {
+    num_species = spec.GetNumSpecies();
+    state_params.assign(256, {0.0, 0.0});
+    open_states.assign(256 * MASK_WORDS, 0);
+    for (size_t colonizer = 0; colonizer < num_species; colonizer++) {
+      const size_t state = SPECIES_C + colonizer;
+      state_params[state] = spec.species[colonizer];
+      uint64_t *open = &open_states[state * MASK_WORDS];
+      open[0] = uint64_t(1) << EMPTY;
+      for (size_t occupant = 0; occupant < num_species; occupant++) {
+        if (spec.displaces[colonizer * num_species + occupant]) {
+          const size_t target = SPECIES_C + occupant;
+          open[target >> 6] |= uint64_t(1) << (target & 63);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Get the number of species in the community
+   */
+  size_t GetNumSpecies() const { return num_species; }
+
+  /**
+   * @brief Initialize the world with a grid structure
+   * @param width Grid width
+   * @param height Grid height
+   */
+  void InitializeGrid(int width, int height) {
+    grid.InitializeGrid(width, height);
+    extinction_events = 0;
+    colonization_events = 0;
+    ecology_updates = 0;
+  }
+
+  /**
+   * @brief Initialize the grid on an external habitat mask; see CompactWorld
+   */
+  void InitializeGrid(std::shared_ptr<const HabitatMask> mask) {
+    grid.InitializeGrid(std::move(mask));
+    extinction_events = 0;
+    colonization_events = 0;
+    ecology_updates = 0;
+  }
+
+  /**
+   * @brief Set the habitat mask without touching any cell (see CompactWorld)
+   */
+  void SetHabitatMask(std::shared_ptr<const HabitatMask> mask) {
+    grid.SetHabitatMask(std::move(mask));
+  }
+
+  /**
+   * @brief Choose the colonization neighbourhood; see CompactWorld::SetNeighborhood
+   */
+  void SetNeighborhood(NeighborhoodType type, bool wrap) {
+    grid.SetNeighborhood(type, wrap);
+  }
+
+  NeighborhoodType GetNeighborhoodType() const { return grid.GetNeighborhoodType(); }
+  bool GetWrapEdges() const { return grid.GetWrapEdges(); }
+
+  /**
+   * @brief Choose where ecology updates take their random numbers from
+   * @param mode SHARED (default) or COUNTER (keyed by seed, update, cell and purpose)
+   * @param seed Key of the CounterRNG, normally the run's seed
+   */
+  void SetRngMode(RngMode mode, uint64_t seed) {
+    rng_mode = mode;
+    counter_rng.SetSeed(seed);
+  }
+
+  uint64_t GetEcologyUpdates() const { return ecology_updates; }
+  void SetEcologyUpdates(uint64_t updates) { ecology_updates = updates; }
+
+  size_t GetSize() const { return grid.GetSize(); }
+  int GetWidth() const { return grid.GetWidth(); }
+  int GetHeight() const { return grid.GetHeight(); }
+  CellState GetState(size_t pos) const { return grid.GetState(pos); }
+  bool IsOccupied(size_t pos) const { return grid.IsOccupied(pos); }
+  bool IsDestroyed(size_t pos) const { return grid.IsDestroyed(pos); }
+
+  /**
+   * @brief Get the species occupying a cell
+   * @param pos Position of an occupied cell
+   * @return Species id
+   */
+  int GetSpecies(size_t pos) const { return grid.GetSpecies(pos); }
+
+  /**
+   * @brief Place an organism of the given species in a cell
+   * @param species Species id, less than GetNumSpecies()
+   * @param pos Position to place it at
+   */
+  void AddOrgAt(int species, size_t pos) { grid.AddOrgAt(species, pos); }
+
+  void RemoveOrganism(size_t pos) { grid.RemoveOrganism(pos); }
+  void DestroyCell(size_t pos) { grid.DestroyCell(pos); }
+  void ClearGrid() { grid.ClearGrid(); }
+
+  /**
+   * @brief Initialize incremental habitat destruction; see CompactWorld
+   */
+  void InitializeIncrementalDestruction(double destruction_percentage, int rounds,
+                                        int pattern) {
+    grid.InitializeIncrementalDestruction(destruction_percentage, rounds, pattern);
+  }
+
+  /**
+   * @brief Initialize habitat destruction from a generated landscape
+   */
+  void InitializeIncrementalDestruction(emp::vector<size_t> order, int rounds) {
+    grid.InitializeIncrementalDestruction(std::move(order), rounds);
+  }
+
+  int ProcessIncrementalDestruction() { return grid.ProcessIncrementalDestruction(); }
+
+  const DestructionSchedule &GetDestructionSchedule() const {
+    return grid.GetDestructionSchedule();
+  }
+
+  bool IsIncrementalDestructionActive() const {
+    return grid.IsIncrementalDestructionActive();
+  }
+
+  /**
+   * @brief Split initial_occupancy of the available habitat evenly among the species
+   * @param initial_occupancy Fraction of available cells to populate
+   *
+   * The available cells are shuffled once; species 0 takes the first block,
+   * species 1 the next and so on.  With two species and occupancy 0.5 this
+   * is CompactWorld::PopulateWithBothSpecies draw for draw.
+   */
+  void PopulateCommunity(double initial_occupancy) {
+    std::vector<size_t> available_cells;
+    for (size_t pos = 0; pos < grid.GetSize(); pos++) {
+      if (!grid.IsDestroyed(pos)) {
+        grid.RemoveOrganism(pos);
+        available_cells.push_back(pos);
+      }
+    }
+    if (num_species == 0)
+      return;
+
+    size_t cells_per_species = static_cast<size_t>(
+        available_cells.size() * initial_occupancy / num_species);
+    StreamDraws draws{random};
+    ShuffleCells(available_cells, draws);
+
+    for (size_t species = 0; species < num_species; species++) {
+      for (size_t i = species * cells_per_species;
+           i < (species + 1) * cells_per_species && i < available_cells.size(); i++) {
+        grid.AddOrgAt(static_cast<int>(species), available_cells[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief Update all organisms for one simulation step
+   */
+  void UpdateEcology() {
+    if (rng_mode == RngMode::COUNTER) {
+      KeyedDraws draws{counter_rng, ecology_updates};
+      UpdateEcologyWith(draws);
+    } else {
+      StreamDraws draws{random};
+      UpdateEcologyWith(draws);
+    }
+    ecology_updates++;
+  }
+
+  /**
+   * @brief Try to colonize a single neighboring cell based on colonization rate
+   * @param pos Position of colonizing organism
+   * @param colonization_rate Rate of colonization
+   */
+  void TryColonize(size_t pos, double colonization_rate) {
+    if (!grid.IsOccupied(pos))
+      return;
+    bool placed;
+    if (rng_mode == RngMode::COUNTER) {
+      KeyedDraws draws{counter_rng, ecology_updates};
+      placed = ColonizeWith(draws, pos, grid.GetState(pos), colonization_rate);
+    } else {
+      StreamDraws draws{random};
+      placed = ColonizeWith(draws, pos, grid.GetState(pos), colonization_rate);
+    }
+    if (placed) {
+      colonization_events++;
+    }
+  }
+
+  /**
+   * @brief Count organisms of each species
+   * @return One count per species id, then empty and destroyed cells
+   */
+  std::vector<int> CountCells() const {
+    std::array<int, 256> by_state = {};
+    for (uint8_t state : grid.GetCells()) {
+      by_state[state]++;
+    }
+    std::vector<int> counts(num_species + 2);
+    for (size_t species = 0; species < num_species; species++) {
+      counts[species] = by_state[SPECIES_C + species];
+    }
+    counts[num_species] = by_state[EMPTY];
+    counts[num_species + 1] = by_state[DESTROYED];
+    return counts;
+  }
+
+  /**
+   * @brief Count the cells of one grid column, in the order of CountCells
+   */
+  std::vector<int> CountColumn(int col) const {
+    std::array<int, 256> by_state = {};
+    const std::vector<uint8_t> &cells = grid.GetCells();
+    for (size_t pos = col; pos < cells.size(); pos += grid.GetWidth()) {
+      by_state[cells[pos]]++;
+    }
+    std::vector<int> counts(num_species + 2);
+    for (size_t species = 0; species < num_species; species++) {
+      counts[species] = by_state[SPECIES_C + species];
+    }
+    counts[num_species] = by_state[EMPTY];
+    counts[num_species + 1] = by_state[DESTROYED];
+    return counts;
+  }
+
+  uint64_t GetExtinctionEvents() const { return extinction_events; }
+  uint64_t GetColonizationEvents() const { return colonization_events; }
+
+  /**
+   * @brief Overwrite the cumulative event counters
+   */
+  void SetEventCounts(uint64_t extinctions, uint64_t colonizations) {
+    extinction_events = extinctions;
+    colonization_events = colonizations;
+  }
+
+private:
+  /**
+   * @brief One asynchronous update: all organisms in one random order
+   */
+  template <typename DRAWS> void UpdateEcologyWith(DRAWS &draws) {
+    const std::vector<uint8_t> &cells = grid.GetCells();
+    std::vector<size_t> occupied_positions;
+    for (size_t pos = 0; pos < cells.size(); pos++) {
+      if (cells[pos] >= SPECIES_C) {
+        occupied_positions.push_back(pos);
+      }
+    }
+
+    ShuffleCells(occupied_positions, draws);
+
+    for (size_t pos : occupied_positions) {
+      const uint8_t state = cells[pos];
+      if (state < SPECIES_C)
+        continue;
+      const SpeciesParams &params = state_params[state];
+      if (draws.P(params.extinction_rate, pos, RngPurpose::EXTINCTION)) {
+        grid.RemoveOrganism(pos);
+        extinction_events++;
+      } else if (ColonizeWith(draws, pos, state, params.colonization_rate)) {
+        colonization_events++;
+      }
+    }
+  }
+
+  /**
+   * @brief Colonization attempt by the organism in state colonizer at pos
+   * @return True if an offspring was placed
+   */
+  template <typename DRAWS>
+  bool ColonizeWith(DRAWS &draws, size_t pos, uint8_t colonizer,
+                    double colonization_rate) {
+    if (!draws.P(colonization_rate, pos, RngPurpose::COLONIZATION))
+      return false;
+
+    const std::vector<uint8_t> &cells = grid.GetCells();
+    const uint64_t *open = &open_states[colonizer * MASK_WORDS];
+    std::array<size_t, Neighborhood::MAX_NEIGHBORS> valid_targets;
+    size_t num_targets = 0;
+    for (size_t neighbor_pos : grid.GetNeighbors(pos)) {
+      const uint8_t target = cells[neighbor_pos];
+      if ((open[target >> 6] >> (target & 63)) & 1) {
+        valid_targets[num_targets++] = neighbor_pos;
+      }
+    }
+    if (num_targets == 0)
+      return false;
+
+    size_t target_pos = valid_targets[draws.GetUInt(num_targets, pos, RngPurpose::TARGET)];
+    grid.AddOrgAt(colonizer - SPECIES_C, target_pos);
+    return true;
+  }
+
+  /**
+   * @brief Fisher-Yates shuffle in CompactWorld's draw order
+   */
+  template <typename DRAWS>
+  static void ShuffleCells(std::vector<size_t> &positions, DRAWS &draws) {
+    for (size_t i = positions.size(); i-- > 1;) {
+      size_t j = draws.GetUInt(i + 1, i, RngPurpose::ORDER);
+      std::swap(positions[i], positions[j]);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,1007 @@
+#ifndef COMPACT_WORLD_H
+#define COMPACT_WORLD_H
+
+#include "emp/math/Random.hpp"
+#include "emp/math/random_utils.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CounterRNG.h"
+#include "DestructionSchedule.h"
+#include "HabitatMask.h"
+#include "Landscape.h"
+#include "Neighborhood.h"
+#include "RandomBuffer.h"
+#include "SpeciesTraits.h"
+#include "SweepRunner.h"
+#include "ThreadPool.h"
+#include "TileLayout.h"
+
+/**
+ * @brief State of a single cell in the compact grid
+ *
+ * Stored as one byte per cell.  Species states start at SPECIES_C so that
+ * (state - SPECIES_C) is the species identifier used by Organism (0=c, 1=d).
+ * Communities with more species continue upward: species i is SPECIES_C + i.
+ */
+enum CellState : uint8_t {
+  EMPTY = 0,     ///< Available habitat with no occupant
+  DESTROYED = 1, ///< Permanently unavailable habitat
+  SPECIES_C = 2, ///< Occupied by species C (superior competitor)
+  SPECIES_D = 3  ///< Occupied by species D (superior disperser)
+};
+
+/**
+ * @brief How UpdateEcology orders the organisms of one update
+ */
+enum class UpdateMode {
+  ASYNCHRONOUS = 0, ///< One global random order; identical to OrgWorld
+  TILED = 1,        ///< Random order within tiles, tiles run in parallel phases
+  SYNCHRONOUS = 2   ///< Every cell updated at once from the previous state
+};
+
+/**
+ * @brief Compact world engine for the habitat destruction simulation
+ *
+ * Runs the same extinction/colonization dynamics as OrgWorld, but stores
+ * each cell as a single CellState byte instead of a heap-allocated Organism,
+ * so births and deaths never touch the allocator.  Random draws are made in
+ * exactly the same order as OrgWorld (and the populate helpers in native.cpp),
+ * so for a given seed both engines produce identical CountCells results.
+ *
+ * The species are a compile-time SpeciesSet: their rates and the
+ * displacement rule are constants, and each organism step dispatches once
+ * on its species to a kernel specialized for it.  A new species is a new
+ * traits type in the set, not new engine code.  CompactWorld is the
+ * two-species community of OrgWorld.
+ *
+ * @tparam SPECIES_SET SpeciesSet of the community
+ */
+template <typename SPECIES_SET> class CompactWorldT {
+public:
+  using Species = SPECIES_SET;
+  static_assert(SPECIES_C + Species::NUM_SPECIES <= 256, "Cell states are one byte");
+
+private:
+  emp::Random &random;
+  std::vector<uint8_t> cells; ///< One CellState per grid cell
+  int grid_width = 0;
+  int grid_height = 0;
+  std::shared_ptr<const HabitatMask> habitat_mask; ///< Permanent non-habitat, if any
+
+  // Incremental destruction
+  DestructionSchedule destruction_schedule; ///< Pre-shuffled cells and round cursor
+
+  // Neighbourhood used for colonization
+  Neighborhood neighborhood; ///< Precomputed neighbour offsets, rebuilt by InitializeGrid
+  NeighborhoodType neighborhood_type = NeighborhoodType::MOORE;
+  bool wrap_edges = false; ///< Toroidal wrapping instead of hard boundaries
+
+  // Event counters, cumulative since InitializeGrid
+  uint64_t extinction_events = 0;   ///< Organisms lost to local extinction
+  uint64_t colonization_events = 0; ///< Successful colonizations
+
+  // Tiled and synchronous update modes
+  UpdateMode update_mode = UpdateMode::ASYNCHRONOUS;
+  int tile_size = 256;                 ///< Requested tile edge in cells
+  size_t update_threads = 1;           ///< Threads for parallel updates (0 = all cores)
+  std::unique_ptr<ThreadPool> pool;    ///< Created on the first parallel update
+  ThreadPool *shared_pool = nullptr;   ///< Used instead of pool, if set
+  TileLayout tiles;                    ///< Rebuilt by InitializeGrid
+  std::vector<std::vector<uint32_t>> tile_cells; ///< Occupied cells of each tile
+  std::vector<std::array<uint64_t, 2>> tile_events; ///< Extinctions, colonizations
+  std::vector<uint8_t> back_cells;     ///< Next state, built by synchronous updates
+  std::vector<uint32_t> sync_targets;  ///< Per-cell decision of a synchronous update
+  std::vector<std::array<uint64_t, 2>> row_events; ///< Extinctions, colonizations
+
+  /// sync_targets values other than a cell position
+  static constexpr uint32_t NO_TARGET = 0xFFFFFFFFu;
+  static constexpr uint32_t WENT_EXTINCT = 0xFFFFFFFEu;
+  /// Mask words per parallel chunk when filling the draw buffer
+  static constexpr size_t DRAW_BUFFER_CHUNK = 256;
+
+  // Random streams of the ecology updates
+  RngMode rng_mode = RngMode::SHARED;
+  CounterRNG counter_rng;        ///< Used in RngMode::COUNTER
+  DrawBuffer draw_buffer;        ///< This update's keyed Bernoulli draws, in bulk
+  uint64_t ecology_updates = 0;  ///< Updates completed since InitializeGrid (draw key)
+
+public:
+  /**
+   * @brief Construct a new CompactWorld
+   * @param _random Reference to random number generator
+   */
+  CompactWorldT(emp::Random &_random) : random(_random) {}
+
+  /**
+   * @brief Initialize the world with a grid structure
+   * @param width Grid width
+   * @param height Grid height
+   */
+  void InitializeGrid(int width, int height) {
+    habitat_mask.reset();
+    grid_width = width;
+    grid_height = height;
+    cells.resize(width * height, EMPTY);
+    neighborhood.Build(width, height, neighborhood_type, wrap_edges);
+    extinction_events = 0;
+    colonization_events = 0;
+    tiles.Build(width, height, tile_size, wrap_edges);
+    ecology_updates = 0;
+  }
+
+  /**
+   * @brief Initialize the grid on an external habitat mask
+   * @param mask Mapped mask; sets the grid size, and its non-habitat cells
+   *        are destroyed for the whole run (see OrgWorld::InitializeGrid)
+   */
+  void InitializeGrid(std::shared_ptr<const HabitatMask> mask) {
+    InitializeGrid(mask->GetWidth(), mask->GetHeight());
+    SetHabitatMask(std::move(mask));
+    ResetDestroyed();
+  }
+
+  /**
+   * @brief Set the habitat mask without touching any cell
+   * @param mask Mask of the same size as the grid, or null for none
+   */
+  void SetHabitatMask(std::shared_ptr<const HabitatMask> mask) {
+    habitat_mask = std::move(mask);
+  }
+
+  /**
+   * @brief Choose the colonization neighbourhood
+   * @param type Moore (8 neighbours, default) or von Neumann (4 neighbours)
+   * @param wrap True for toroidal wrapping, false for hard boundaries (default)
+   *
+   * Takes effect at the next InitializeGrid.
+   */
+  void SetNeighborhood(NeighborhoodType type, bool wrap) {
+    neighborhood_type = type;
+    wrap_edges = wrap;
+  }
+
+  /**
+   * @brief Choose how UpdateEcology orders organisms
+   * @param mode ASYNCHRONOUS (default, identical to OrgWorld), TILED or SYNCHRONOUS
+   * @param _tile_size Tile edge for TILED mode, in cells
+   * @param threads Threads for TILED and SYNCHRONOUS modes (0 = all cores);
+   *                results do not depend on it
+   *
+   * The tile size takes effect at the next InitializeGrid.
+   */
+  void SetUpdateMode(UpdateMode mode, int _tile_size = 256, size_t threads = 1) {
+    update_mode = mode;
+    tile_size = _tile_size;
+    if (threads != update_threads) {
+      update_threads = threads;
+      pool.reset();
+    }
+  }
+
+  UpdateMode GetUpdateMode() const { return update_mode; }
+
+  /**
+   * @brief Run the parallel update modes on a pool owned by the caller
+   * @param _shared_pool Pool to use, or nullptr for the world's own pool of
+   *        update_threads threads
+   *
+   * Lets a sweep reuse one pool for many worlds instead of starting and
+   * joining threads for each.  The pool must outlive its use by this world
+   * and must not run another ParallelFor at the same time.
+   */
+  void SetThreadPool(ThreadPool *_shared_pool) { shared_pool = _shared_pool; }
+
+  /**
+   * @brief Choose where ecology updates take their random numbers from
+   * @param mode SHARED (default, identical to OrgWorld's shared mode) or
+   *             COUNTER (keyed by seed, update, cell and purpose)
+   * @param seed Key of the CounterRNG, normally the run's seed
+   *
+   * With COUNTER the asynchronous mode matches OrgWorld's COUNTER mode draw
+   * for draw, and the tiled and synchronous modes use no per-tile or per-row
+   * streams, so the synchronous mode gives the same result for any split.
+   */
+  void SetRngMode(RngMode mode, uint64_t seed) {
+    rng_mode = mode;
+    counter_rng.SetSeed(seed);
+  }
+
+  /**
+   * @brief Get the number of ecology updates completed since InitializeGrid
+   */
+  uint64_t GetEcologyUpdates() const { return ecology_updates; }
+
+  /**
+   * @brief Overwrite the ecology update count (used by checkpoints)
+   */
+  void SetEcologyUpdates(uint64_t updates) { ecology_updates = updates; }
+
+  /**
+   * @brief Get the configured colonization neighbourhood
+   */
+  NeighborhoodType GetNeighborhoodType() const { return neighborhood_type; }
+
+  /**
+   * @brief Check whether the grid edges wrap
+   */
+  bool GetWrapEdges() const { return wrap_edges; }
+
+  /**
+   * @brief Get the precomputed neighbours of a cell
+   * @param pos Center position
+   * @return View over the neighbouring positions
+   */
+  NeighborView GetNeighbors(size_t pos) const {
+    return neighborhood.GetNeighbors(pos);
+  }
+
+  /**
+   * @brief Get the parameters of one species
+   * @param species Species identifier (0=c, 1=d)
+   * @return Colonization and extinction rates, fixed by the SpeciesSet
+   */
+  const SpeciesParams &GetSpeciesParams(int species) const {
+    return Species::PARAMS[species];
+  }
+
+  size_t GetSize() const { return cells.size(); }
+  int GetWidth() const { return grid_width; }
+  int GetHeight() const { return grid_height; }
+
+  /**
+   * @brief Get the raw state of a cell
+   * @param pos Position to check
+   * @return CellState of the cell
+   */
+  CellState GetState(size_t pos) const {
+    return static_cast<CellState>(cells[pos]);
+  }
+
+  /**
+   * @brief Get every cell's raw state, one byte per cell in row-major order
+   */
+  const std::vector<uint8_t> &GetCells() const { return cells; }
+
+  /**
+   * @brief Check if a cell is occupied by either species
+   * @param pos Position to check
+   * @return True if the cell holds an organism
+   */
+  bool IsOccupied(size_t pos) const {
+    return pos < cells.size() && cells[pos] >= SPECIES_C;
+  }
+
+  /**
+   * @brief Check if a cell is destroyed habitat
+   * @param pos Position to check
+   * @return True if cell is destroyed
+   */
+  bool IsDestroyed(size_t pos) const {
+    return pos < cells.size() && cells[pos] == DESTROYED;
+  }
+
+  /**
+   * @brief Check if a cell is available (not destroyed)
+   * @param pos Position to check
+   * @return True if cell is available habitat
+   */
+  bool IsAvailable(size_t pos) const {
+    return pos < cells.size() && cells[pos] != DESTROYED;
+  }
+
+  /**
+   * @brief Get the species occupying a cell
+   * @param pos Position of an occupied cell
+   * @return Species ID (0=c, 1=d)
+   */
+  int GetSpecies(size_t pos) const { return cells[pos] - SPECIES_C; }
+
+  /**
+   * @brief Place an organism of the given species in a cell
+   * @param species Species identifier (0=c, 1=d)
+   * @param pos Position to place it at
+   */
+  void AddOrgAt(int species, size_t pos) {
+    cells[pos] = static_cast<uint8_t>(SPECIES_C + species);
+  }
+
+  /**
+   * @brief Remove organism from the world
+   * @param i Position index
+   */
+  void RemoveOrganism(size_t i) {
+    if (IsOccupied(i)) {
+      cells[i] = EMPTY;
+    }
+  }
+
+  /**
+   * @brief Destroy a cell, killing any occupant
+   * @param pos Position to destroy
+   */
+  void DestroyCell(size_t pos) { cells[pos] = DESTROYED; }
+
+  /**
+   * @brief Return every cell to empty, intact habitat
+   */
+  void ClearGrid() { std::fill(cells.begin(), cells.end(), EMPTY); }
+
+  /**
+   * @brief Destroy habitat cells randomly
+   * @param destruction_percentage Percentage of cells to destroy (0.0 to 1.0)
+   */
+  void DestroyHabitatRandom(double destruction_percentage) {
+    DestroyLandscape(LandscapeGenerator::Generate(
+        static_cast<int>(LandscapePattern::RANDOM), destruction_percentage,
+        grid_width, grid_height, random, habitat_mask.get()));
+  }
+
+  /**
+   * @brief Destroy habitat cells in a gradient pattern
+   * @param destruction_percentage Average percentage of cells to destroy (0.0 to 1.0)
+   *
+   * Same left-to-right linear gradient as OrgWorld::DestroyHabitatGradient.
+   */
+  void DestroyHabitatGradient(double destruction_percentage) {
+    DestroyLandscape(LandscapeGenerator::Generate(
+        static_cast<int>(LandscapePattern::GRADIENT), destruction_percentage,
+        grid_width, grid_height, random, habitat_mask.get()));
+  }
+
+  /**
+   * @brief Initialize incremental habitat destruction
+   * @param destruction_percentage Percentage of cells to destroy (0.0 to 1.0)
+   * @param rounds Number of rounds to spread destruction over (0 = immediate)
+   * @param pattern Destruction pattern (LandscapePattern): 0=Random,
+   *        1=Gradient, 2=Clumped, 3=Percolation
+   */
+  void InitializeIncrementalDestruction(double destruction_percentage, int rounds, int pattern) {
+    InitializeIncrementalDestruction(
+        LandscapeGenerator::Generate(pattern, destruction_percentage, grid_width,
+                                     grid_height, random, habitat_mask.get()),
+        rounds);
+  }
+
+  /**
+   * @brief Initialize habitat destruction from a generated landscape
+   * @param order Cells in destruction order (see LandscapeGenerator)
+   * @param rounds Number of rounds to spread destruction over (0 = immediate)
+   */
+  void InitializeIncrementalDestruction(emp::vector<size_t> order, int rounds) {
+    destruction_schedule.Clear();
+    if (rounds == 0) {
+      DestroyLandscape(order);
+      return;
+    }
+    ResetDestroyed();
+    if (habitat_mask) {
+      // Generated landscapes already skip the mask; orders made without it
+      // (checkpoints, external landscapes) may not
+      habitat_mask->RemoveDestroyed(order);
+    }
+    destruction_schedule.Reset(std::move(order), rounds);
+  }
+
+  /**
+   * @brief Process one round of incremental destruction
+   * @return Number of cells destroyed this round
+   */
+  int ProcessIncrementalDestruction() {
+    auto [first, last] = destruction_schedule.NextRound();
+    const emp::vector<size_t> &order = destruction_schedule.GetOrder();
+    for (size_t i = first; i < last; i++) {
+      DestroyCell(order[i]);
+    }
+    return static_cast<int>(last - first);
+  }
+
+  /**
+   * @brief Jump incremental destruction to the start of any round
+   * @param round Round to jump to (0 = nothing destroyed yet)
+   *
+   * Same semantics as OrgWorld::JumpToDestructionRound.
+   */
+  void JumpToDestructionRound(int round) {
+    size_t previous = destruction_schedule.SeekRound(round);
+    size_t target = destruction_schedule.GetCursor();
+    const emp::vector<size_t> &order = destruction_schedule.GetOrder();
+    for (size_t i = previous; i < target; i++) {
+      DestroyCell(order[i]);
+    }
+    for (size_t i = target; i < previous; i++) {
+      cells[order[i]] = EMPTY;
+    }
+  }
+
+  /**
+   * @brief Get the incremental destruction schedule
+   * @return Schedule with the destruction order, current round and remaining cells
+   */
+  const DestructionSchedule &GetDestructionSchedule() const {
+    return destruction_schedule;
+  }
+
+  /**
+   * @brief Restore a destruction schedule without touching any cell
+   * @param order Cells in destruction order
+   * @param total_rounds Rounds the order is spread over
+   * @param round Rounds already processed
+   *
+   * Used when loading a checkpoint, whose cells already reflect the rounds
+   * processed so far.
+   */
+  void RestoreDestructionSchedule(emp::vector<size_t> order, int total_rounds,
+                                  int round) {
+    destruction_schedule.Reset(std::move(order), total_rounds);
+    destruction_schedule.SeekRound(round);
+  }
+
+  /**
+   * @brief Check if incremental destruction is active
+   * @return True if there are still rounds of destruction remaining
+   */
+  bool IsIncrementalDestructionActive() const {
+    return destruction_schedule.IsActive();
+  }
+
+  /**
+   * @brief Add both species to occupy initial_occupancy / 2 each of available habitat
+   * @param initial_occupancy Fraction of available cells to populate
+   *
+   * Consumes random numbers in the same order as PopulateWithBothSpecies
+   * in Populate.h so that both engines start from the same grid.
+   */
+  void PopulateWithBothSpecies(double initial_occupancy) {
+    std::vector<size_t> available_cells = ClearAndListAvailable();
+
+    size_t cells_per_species =
+        static_cast<size_t>(available_cells.size() * initial_occupancy / 2);
+    ShuffleCells(available_cells);
+
+    for (size_t i = 0; i < cells_per_species && i < available_cells.size(); i++) {
+      AddOrgAt(0, available_cells[i]);
+    }
+    for (size_t i = cells_per_species;
+         i < cells_per_species * 2 && i < available_cells.size(); i++) {
+      AddOrgAt(1, available_cells[i]);
+    }
+  }
+
+  /**
+   * @brief Add species D to initial_occupancy of the available habitat
+   * @param initial_occupancy Fraction of available cells to populate
+   */
+  void PopulateWithSpeciesD(double initial_occupancy) {
+    std::vector<size_t> available_cells = ClearAndListAvailable();
+
+    size_t target_organisms =
+        static_cast<size_t>(available_cells.size() * initial_occupancy);
+    ShuffleCells(available_cells);
+
+    for (size_t i = 0; i < target_organisms && i < available_cells.size(); i++) {
+      AddOrgAt(1, available_cells[i]);
+    }
+  }
+
+  /**
+   * @brief Update all organisms for one simulation step
+   */
+  void UpdateEcology() {
+    if (update_mode == UpdateMode::TILED) {
+      UpdateEcologyTiled();
+    } else if (update_mode == UpdateMode::SYNCHRONOUS) {
+      UpdateEcologySynchronous();
+    } else if (rng_mode == RngMode::COUNTER) {
+      FillDrawBuffer();
+      BufferedDraws draws{counter_rng, ecology_updates, draw_buffer};
+      UpdateEcologyAsynchronous(draws);
+    } else {
+      StreamDraws draws{random};
+      UpdateEcologyAsynchronous(draws);
+    }
+    ecology_updates++;
+  }
+
+  /**
+   * @brief Try to colonize a single neighboring cell based on colonization rate
+   * @param pos Position of colonizing organism
+   * @param colonization_rate Rate of colonization
+   *
+   * Same rules as OrgWorld::TryColonize: species C can colonize empty cells
+   * and displace species D, species D can only colonize empty cells.
+   */
+  void TryColonize(size_t pos, double colonization_rate) {
+    if (!IsOccupied(pos))
+      return;
+    bool placed = Species::Dispatch(cells[pos] - SPECIES_C, [&](auto species) {
+      if (rng_mode == RngMode::COUNTER) {
+        KeyedDraws draws{counter_rng, ecology_updates};
+        return ColonizeAs<species>(draws, pos, colonization_rate);
+      }
+      StreamDraws draws{random};
+      return ColonizeAs<species>(draws, pos, colonization_rate);
+    });
+    if (placed) {
+      colonization_events++;
+    }
+  }
+
+  /**
+   * @brief Get the number of local extinctions since InitializeGrid
+   */
+  uint64_t GetExtinctionEvents() const { return extinction_events; }
+
+  /**
+   * @brief Get the number of successful colonizations since InitializeGrid
+   */
+  uint64_t GetColonizationEvents() const { return colonization_events; }
+
+  /**
+   * @brief Overwrite the cumulative event counters (used by checkpoints)
+   */
+  void SetEventCounts(uint64_t extinctions, uint64_t colonizations) {
+    extinction_events = extinctions;
+    colonization_events = colonizations;
+  }
+
+  /**
+   * @brief Count organisms of each species
+   * @return Array with counts [species_c, species_d, empty, destroyed]; with
+   *         more species, one count per species id, then empty and destroyed
+   */
+  std::array<int, Species::NUM_STATES> CountCells() const {
+    std::array<int, Species::NUM_STATES> by_state = {};
+    for (uint8_t state : cells) {
+      by_state[state]++;
+    }
+    std::array<int, Species::NUM_STATES> counts;
+    for (size_t species = 0; species < Species::NUM_SPECIES; species++) {
+      counts[species] = by_state[SPECIES_C + species];
+    }
+    counts[Species::NUM_SPECIES] = by_state[EMPTY];
+    counts[Species::NUM_SPECIES + 1] = by_state[DESTROYED];
+    return counts;
+  }
+
+  /**
+   * @brief Count the cells of one grid column, e.g. along a destruction gradient
+   * @param col Column in [0, GetWidth())
+   * @return Counts in the order of CountCells
+   */
+  std::array<int, Species::NUM_STATES> CountColumn(int col) const {
+    std::array<int, Species::NUM_STATES> by_state = {};
+    for (size_t pos = col; pos < cells.size(); pos += grid_width) {
+      by_state[cells[pos]]++;
+    }
+    std::array<int, Species::NUM_STATES> counts;
+    for (size_t species = 0; species < Species::NUM_SPECIES; species++) {
+      counts[species] = by_state[SPECIES_C + species];
+    }
+    counts[Species::NUM_SPECIES] = by_state[EMPTY];
+    counts[Species::NUM_SPECIES + 1] = by_state[DESTROYED];
+    return counts;
+  }
+
+private:
+  /**
+   * @brief Collect the neighbours of pos that species S can colonize
+   * @param pos Center position
+   * @param valid_targets Filled in OrgWorld's neighbour order
+   * @return Number of targets
+   *
+   * A target is valid if its state is in the compile-time mask of states S
+   * can enter, so the test is one shift whatever the community.
+   */
+  template <size_t S>
+  size_t FindTargets(size_t pos,
+                     std::array<size_t, Neighborhood::MAX_NEIGHBORS> &valid_targets) const {
+    constexpr uint64_t open = Species::OpenStates(S);
+    size_t num_targets = 0;
+    for (size_t neighbor_pos : neighborhood.GetNeighbors(pos)) {
+      if ((open >> cells[neighbor_pos]) & 1) {
+        valid_targets[num_targets++] = neighbor_pos;
+      }
+    }
+    return num_targets;
+  }
+
+  /**
+   * @brief TryColonize by an organism of species S with explicit draws
+   * @return True if an offspring was placed
+   */
+  template <size_t S, typename DRAWS>
+  bool ColonizeAs(DRAWS &draws, size_t pos, double colonization_rate) {
+    if (!draws.P(colonization_rate, pos, RngPurpose::COLONIZATION))
+      return false;
+
+    // At most 8 neighbors, kept on the stack in OrgWorld's neighbor order
+    std::array<size_t, Neighborhood::MAX_NEIGHBORS> valid_targets;
+    size_t num_targets = FindTargets<S>(pos, valid_targets);
+    if (num_targets == 0)
+      return false;
+
+    size_t target_index = draws.GetUInt(num_targets, pos, RngPurpose::TARGET);
+    cells[valid_targets[target_index]] = static_cast<uint8_t>(SPECIES_C + S);
+    return true;
+  }
+
+  /**
+   * @brief Process a single organism's extinction and colonization
+   * @param draws StreamDraws or KeyedDraws
+   * @param pos Position of organism to process
+   * @param extinctions Incremented if the organism goes extinct
+   * @param colonizations Incremented if it places an offspring
+   *
+   * Mirrors SpeciesC/SpeciesD::ProcessInWorld, with the species' rates as
+   * compile-time constants.
+   */
+  template <typename DRAWS>
+  void ProcessOrganismWith(DRAWS &draws, size_t pos, uint64_t &extinctions,
+                           uint64_t &colonizations) {
+    Species::Dispatch(cells[pos] - SPECIES_C, [&](auto species) {
+      using Traits = typename Species::template TraitsOf<species>;
+      if (draws.P(Traits::EXTINCTION_RATE, pos, RngPurpose::EXTINCTION)) {
+        cells[pos] = EMPTY;
+        extinctions++;
+      } else if (ColonizeAs<species>(draws, pos, Traits::COLONIZATION_RATE)) {
+        colonizations++;
+      }
+      return true;
+    });
+  }
+
+  /**
+   * @brief One update in ASYNCHRONOUS mode: all organisms in one random order
+   */
+  template <typename DRAWS> void UpdateEcologyAsynchronous(DRAWS &draws) {
+    emp::vector<size_t> occupied_positions;
+    for (size_t i = 0; i < cells.size(); i++) {
+      if (cells[i] >= SPECIES_C) {
+        occupied_positions.push_back(i);
+      }
+    }
+
+    ShuffleCells(occupied_positions, draws, 0);
+
+    for (size_t pos : occupied_positions) {
+      if (cells[pos] >= SPECIES_C) {
+        ProcessOrganismWith(draws, pos, extinction_events, colonization_events);
+      }
+    }
+  }
+
+  /**
+   * @brief One update in TILED mode
+   *
+   * The occupied cells of every tile are listed first, so as in the
+   * asynchronous mode each organism alive at the start of the update is
+   * processed at most once.  Then the phases run in order; the tiles of a
+   * phase run concurrently, each in its own random order drawn from its own
+   * stream, seeded from (update seed, tile).  Colonizations may cross into
+   * neighbouring tiles: those belong to other phases and are idle, so the
+   * conflict rule is simply "phase order, then the tile's own order".  The
+   * update seed is one draw from the world's generator, so results depend
+   * on the run's seed but not on the number of threads.  In RngMode::COUNTER
+   * the tiles draw keyed numbers instead and the world's generator is not
+   * used.
+   */
+  void UpdateEcologyTiled() {
+    ThreadPool &workers = GetPool();
+    const size_t num_tiles = tiles.GetNumTiles();
+    tile_cells.resize(num_tiles);
+    tile_events.assign(num_tiles, {0, 0});
+    const bool keyed = rng_mode == RngMode::COUNTER;
+    const int update_seed = keyed ? 0 : static_cast<int>(random.GetUInt(2147483647u));
+    if (keyed) {
+      FillDrawBuffer();
+    }
+
+    workers.ParallelFor(num_tiles, [this](size_t tile) {
+      int x0, x1, y0, y1;
+      tiles.GetBounds(tile, x0, x1, y0, y1);
+      std::vector<uint32_t> &list = tile_cells[tile];
+      list.clear();
+      for (int y = y0; y < y1; y++) {
+        size_t row = static_cast<size_t>(y) * grid_width;
+        for (int x = x0; x < x1; x++) {
+          if (cells[row + x] >= SPECIES_C) {
+            list.push_back(static_cast<uint32_t>(row + x));
+          }
+        }
+      }
+    });
+
+    for (const std::vector<size_t> &phase : tiles.GetPhases()) {
+      workers.ParallelFor(phase.size(), [&](size_t i) {
+        size_t tile = phase[i];
+        if (keyed) {
+          BufferedDraws draws{counter_rng, ecology_updates, draw_buffer};
+          ProcessTile(draws, tile);
+        } else {
+          emp::Random rng(DeriveSeed(update_seed, ecology_updates, tile));
+          StreamDraws draws{rng};
+          ProcessTile(draws, tile);
+        }
+      });
+    }
+
+    for (const std::array<uint64_t, 2> &events : tile_events) {
+      extinction_events += events[0];
+      colonization_events += events[1];
+    }
+  }
+
+  /**
+   * @brief Shuffle and process the organisms listed for one tile
+   *
+   * The shuffle keys of tile t start at t << 32, so they never collide.
+   */
+  template <typename DRAWS> void ProcessTile(DRAWS &draws, size_t tile) {
+    std::vector<uint32_t> &list = tile_cells[tile];
+    ShuffleCells(list, draws, static_cast<uint64_t>(tile) << 32);
+    std::array<uint64_t, 2> &events = tile_events[tile];
+    for (uint32_t pos : list) {
+      if (cells[pos] >= SPECIES_C) {
+        ProcessOrganismWith(draws, pos, events[0], events[1]);
+      }
+    }
+  }
+
+  /**
+   * @brief One update in SYNCHRONOUS mode
+   *
+   * Two data-parallel passes over the rows, both reading only the state at
+   * the start of the update.  The decide pass draws each organism's
+   * extinction and colonization exactly as ProcessOrganism does and records
+   * either WENT_EXTINCT or the chosen target (NO_TARGET if it stays put);
+   * each row uses its own stream seeded from (update seed, row), or in
+   * RngMode::COUNTER keyed numbers from the draw buffer.  The resolve pass
+   * then builds every cell of the next state from its own
+   * decision and its neighbours' targets: a cell targeted by any C becomes
+   * C, otherwise one targeted by a D becomes D, otherwise it keeps its
+   * state unless its occupant went extinct (in general the best-ranked
+   * colonizer settles).  Neighbourhoods are symmetric, so "neighbours that
+   * chose me" covers every colonizer.  Each newly settled cell counts as
+   * one colonization.
+   */
+  void UpdateEcologySynchronous() {
+    ThreadPool &workers = GetPool();
+    const size_t num_rows = static_cast<size_t>(grid_height);
+    back_cells.resize(cells.size());
+    sync_targets.resize(cells.size());
+    row_events.assign(num_rows, {0, 0});
+    const bool keyed = rng_mode == RngMode::COUNTER;
+    const int update_seed = keyed ? 0 : static_cast<int>(random.GetUInt(2147483647u));
+    if (keyed) {
+      FillDrawBuffer();
+    }
+
+    workers.ParallelFor(num_rows, [&](size_t row) {
+      const size_t first = row * grid_width;
+      const size_t last = first + grid_width;
+      uint64_t &extinctions = row_events[row][0];
+      if (keyed) {
+        BufferedDraws draws{counter_rng, ecology_updates, draw_buffer};
+        for (size_t pos = first; pos < last; pos++) {
+          sync_targets[pos] = DecideSynchronous(draws, pos, extinctions);
+        }
+      } else {
+        emp::Random rng(DeriveSeed(update_seed, ecology_updates, row));
+        StreamDraws draws{rng};
+        for (size_t pos = first; pos < last; pos++) {
+          sync_targets[pos] = DecideSynchronous(draws, pos, extinctions);
+        }
+      }
+    });
+
+    // States no neighbour can have chosen, and each state's rank (best first)
+    constexpr uint64_t closed = Species::ClosedStates();
+    constexpr int best_rank = *std::min_element(Species::RANKS.begin(), Species::RANKS.end());
+    workers.ParallelFor(num_rows, [&](size_t row) {
+      const size_t first = row * grid_width;
+      for (size_t pos = first; pos < first + grid_width; pos++) {
+        uint8_t state = cells[pos];
+        uint8_t next = (state >= SPECIES_C && sync_targets[pos] == WENT_EXTINCT)
+                           ? static_cast<uint8_t>(EMPTY)
+                           : state;
+        if ((closed >> state) & 1) {
+          back_cells[pos] = next;
+          continue;
+        }
+        uint8_t settler = EMPTY;
+        for (size_t neighbor_pos : neighborhood.GetNeighbors(pos)) {
+          if (sync_targets[neighbor_pos] == pos) {
+            uint8_t candidate = cells[neighbor_pos];
+            if (settler == EMPTY || Species::Displaces(candidate - SPECIES_C,
+                                                       settler - SPECIES_C)) {
+              settler = candidate;
+              if (Species::RANKS[settler - SPECIES_C] == best_rank)
+                break;
+            }
+          }
+        }
+        if (settler != EMPTY) {
+          next = settler;
+          row_events[row][1]++;
+        }
+        back_cells[pos] = next;
+      }
+    });
+
+    cells.swap(back_cells);
+    for (const std::array<uint64_t, 2> &events : row_events) {
+      extinction_events += events[0];
+      colonization_events += events[1];
+    }
+  }
+
+  /**
+   * @brief Decide pass of a synchronous update for one cell
+   * @param draws StreamDraws of the cell's row, or BufferedDraws
+   * @param pos Cell to decide
+   * @param extinctions Incremented if the occupant goes extinct
+   * @return WENT_EXTINCT, NO_TARGET or the position the occupant colonizes
+   */
+  template <typename DRAWS>
+  uint32_t DecideSynchronous(DRAWS &draws, size_t pos, uint64_t &extinctions) {
+    if (cells[pos] < SPECIES_C)
+      return NO_TARGET;
+    return Species::Dispatch(cells[pos] - SPECIES_C, [&](auto species) {
+      using Traits = typename Species::template TraitsOf<species>;
+      if (draws.P(Traits::EXTINCTION_RATE, pos, RngPurpose::EXTINCTION)) {
+        extinctions++;
+        return WENT_EXTINCT;
+      }
+      if (!draws.P(Traits::COLONIZATION_RATE, pos, RngPurpose::COLONIZATION))
+        return NO_TARGET;
+
+      std::array<size_t, Neighborhood::MAX_NEIGHBORS> valid_targets;
+      size_t num_targets = FindTargets<species>(pos, valid_targets);
+      if (num_targets == 0)
+        return NO_TARGET;
+      return static_cast<uint32_t>(
+          valid_targets[draws.GetUInt(num_targets, pos, RngPurpose::TARGET)]);
+    });
+  }
+
+  /**
+   * @brief Make this update's keyed extinction and colonization draws in bulk
+   *
+   * Blocks of 64 cells without an organism are skipped; only cells occupied
+   * at the start of the update are ever processed, so none of them is
+   * queried.  The parallel modes fill chunks of the buffer on the pool.
+   */
+  void FillDrawBuffer() {
+    for (const SpeciesParams &params : Species::PARAMS) {
+      draw_buffer.Register(RngPurpose::EXTINCTION, params.extinction_rate);
+      draw_buffer.Register(RngPurpose::COLONIZATION, params.colonization_rate);
+    }
+    const size_t num_cells = cells.size();
+    const size_t num_words = (num_cells + 63) / 64;
+    auto active = [this, num_cells](size_t word) {
+      const size_t last = std::min(num_cells, word * 64 + 64);
+      for (size_t pos = word * 64; pos < last; pos++) {
+        if (cells[pos] >= SPECIES_C)
+          return true;
+      }
+      return false;
+    };
+
+    draw_buffer.Prepare(num_cells);
+    if (update_mode == UpdateMode::ASYNCHRONOUS) {
+      draw_buffer.FillWords(counter_rng, ecology_updates, 0, num_words, active);
+    } else {
+      const size_t num_chunks = (num_words + DRAW_BUFFER_CHUNK - 1) / DRAW_BUFFER_CHUNK;
+      GetPool().ParallelFor(num_chunks, [&](size_t chunk) {
+        draw_buffer.FillWords(counter_rng, ecology_updates,
+                              chunk * DRAW_BUFFER_CHUNK,
+                              std::min(num_words, (chunk + 1) * DRAW_BUFFER_CHUNK),
+                              active);
+      });
+    }
+    draw_buffer.MarkFilled(ecology_updates);
+  }
+
+  /**
+   * @brief Get the worker pool of the parallel update modes, creating it once
+   */
+  ThreadPool &GetPool() {
+    if (shared_pool)
+      return *shared_pool;
+    if (!pool) {
+      pool = std::make_unique<ThreadPool>(update_threads);
+    }
+    return *pool;
+  }
+
+  /**
+   * @brief Clear all destroyed cells back to empty habitat, except those of
+   *        the habitat mask, which are destroyed along with their occupants
+   */
+  void ResetDestroyed() {
+    for (uint8_t &state : cells) {
+      if (state == DESTROYED)
+        state = EMPTY;
+    }
+    if (habitat_mask) {
+      std::vector<uint64_t> mask_words((cells.size() + 63) / 64);
+      habitat_mask->FillDestroyedWords(mask_words.data());
+      for (size_t w = 0; w < mask_words.size(); w++) {
+        for (uint64_t bits = mask_words[w]; bits; bits &= bits - 1) {
+          cells[w * 64 + __builtin_ctzll(bits)] = DESTROYED;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Destroy exactly the cells of a landscape, restoring all others
+   */
+  void DestroyLandscape(const emp::vector<size_t> &order) {
+    ResetDestroyed();
+    for (size_t pos : order) {
+      DestroyCell(pos);
+    }
+  }
+
+  /**
+   * @brief Remove all organisms and list the available cells
+   * @return Positions of all non-destroyed cells in index order
+   */
+  std::vector<size_t> ClearAndListAvailable() {
+    std::vector<size_t> available_cells;
+    for (size_t i = 0; i < cells.size(); i++) {
+      if (cells[i] != DESTROYED) {
+        cells[i] = EMPTY;
+        available_cells.push_back(i);
+      }
+    }
+    return available_cells;
+  }
+
+  /**
+   * @brief Fisher-Yates shuffle matching the manual shuffles in OrgWorld
+   * @param positions Cells to shuffle in place
+   */
+  template <typename VEC> void ShuffleCells(VEC &positions) {
+    ShuffleCells(positions, random);
+  }
+
+  template <typename VEC> void ShuffleCells(VEC &positions, emp::Random &rng) {
+    for (size_t i = positions.size(); i-- > 1;) {
+      size_t j = rng.GetUInt(i + 1);
+      std::swap(positions[i], positions[j]);
+    }
+  }
+
+  /**
+   * @brief Fisher-Yates shuffle with keyed swap indices generated in bulk
+   */
+  template <typename VEC>
+  void ShuffleCells(VEC &positions, BufferedDraws &draws, uint64_t key_base) {
+    KeyedShuffle(positions, draws.rng, draws.update, key_base);
+  }
+
+  /**
+   * @brief Fisher-Yates shuffle with StreamDraws or KeyedDraws
+   * @param positions Cells to shuffle in place
+   * @param draws Source of the swap indices
+   * @param key_base Added to the step index to form the ORDER key
+   */
+  template <typename VEC, typename DRAWS>
+  void ShuffleCells(VEC &positions, DRAWS &draws, uint64_t key_base) {
+    for (size_t i = positions.size(); i-- > 1;) {
+      size_t j = draws.GetUInt(i + 1, key_base + i, RngPurpose::ORDER);
+      std::swap(positions[i], positions[j]);
+    }
+  }
+};
+
+/// Compact engine for the two-species model of OrgWorld
+using CompactWorld = CompactWorldT<CompetitionColonization>;
+
+#endif
@@ -1,8 +1,61 @@
+#ifndef CONFIG_SETUP_H
+#define CONFIG_SETUP_H
+
 #include "emp/config/ArgManager.hpp"
 
 EMP_BUILD_CONFIG(MyConfigType,
     VALUE(SEED, int, 9, "What value should the random seed be?"), 
-    VALUE(DESTRUCTION_PATTERN, int, 0, "Destruction pattern: 0=Random, 1=Gradient"),
+    VALUE(DESTRUCTION_PATTERN, int, 0, "Destruction pattern: 0=Random, 1=Gradient, 2=Clumped (fractal), 3=Percolation cluster"),
     VALUE(PERCENT_DESTROYED, float, 0.5, "What percent of habitant should be destroyed?"),
-    VALUE(DESTRUCTION_ROUNDS, int, 10, "Number of rounds to incrementally destroy habitat (0-100, 0=immediate)")
-  )
\ No newline at end of file
+    VALUE(DESTRUCTION_ROUNDS, int, 10, "Number of rounds to incrementally destroy habitat (0-100, 0=immediate)"),
+    VALUE(NEIGHBORHOOD, int, 0, "Colonization neighbourhood: 0=Moore (8 cells), 1=von Neumann (4 cells)"),
+    VALUE(WRAP_EDGES, int, 0, "Grid edges: 0=hard boundaries, 1=toroidal wrapping"),
+    VALUE(ENGINE, int, 0, "World engine for native runs: 0=Organism objects, 1=Compact grid, 2=Continuous-time model (differs from 0 and 1), 3=N-species community"),
+    VALUE(UPDATE_MODE, int, 0, "Compact-engine update order: 0=one random order (as Organism engine), 1=tiled parallel, 2=synchronous"),
+    VALUE(TILE_SIZE, int, 256, "Tile edge in cells for UPDATE_MODE 1"),
+    VALUE(UPDATE_THREADS, int, 1, "Threads per run for UPDATE_MODE 1 and 2 (0=the cores NUM_THREADS leaves); output does not depend on it"),
+    VALUE(RNG_MODE, int, 0, "Ecology random numbers: 0=one shared generator, 1=counter-based, keyed by seed/update/cell"),
+
+  GROUP(SWEEP, "Native sweep settings; axes are a value, a list a,b,c or a range min:max:step"),
+    VALUE(SWEEP_DESTROYED, std::string, "", "Fractions destroyed to sweep (empty=PERCENT_DESTROYED)"),
+    VALUE(SWEEP_ROUNDS, std::string, "0:100:1", "Destruction rounds to sweep (empty=DESTRUCTION_ROUNDS)"),
+    VALUE(SWEEP_PATTERNS, std::string, "", "Destruction patterns to sweep (empty=DESTRUCTION_PATTERN)"),
+    VALUE(GRID_WIDTH, int, 50, "Grid width for native runs and the web viewer"),
+    VALUE(GRID_HEIGHT, int, 50, "Grid height for native runs and the web viewer"),
+    VALUE(HABITAT_MASK, std::string, "", "PGM, PBM or raw byte file of habitat (0=non-habitat, black in PBM); sets the grid size except for raw files (empty=none)"),
+    VALUE(UPDATES, int, 1000, "Ecology updates per native run"),
+    VALUE(INITIAL_OCCUPANCY, double, 0.5, "Fraction of available habitat populated at the start"),
+    VALUE(REPLICATES, int, 1, "Number of independent replicates per parameter value in native sweeps"),
+    VALUE(COLUMN_COUNTS, int, 0, "1=also write each run's final counts per grid column to a _columns.csv (e.g. along a gradient)"),
+    VALUE(REPLICATE_SUMMARY, int, 0, "Replicate statistics per point in a _summary.csv: 0=off, 1=as well as the per-run CSV, 2=instead of it"),
+    VALUE(NUM_THREADS, int, 0, "Threads for native sweeps (0=all cores); output does not depend on it"),
+    VALUE(SHARD_INDEX, int, 0, "Which part of the job list this process runs (0..SHARD_COUNT-1)"),
+    VALUE(SHARD_COUNT, int, 1, "Number of parts the job list is split into across processes"),
+    VALUE(LANDSCAPE_SEED, int, -1, "Seed of destruction landscapes (-1=drawn by each run); otherwise shared by all runs of a pattern, fraction and replicate"),
+
+  GROUP(CHECKPOINT, "Shared starting state for native sweeps"),
+    VALUE(BURN_IN, int, 0, "Updates run on the intact, populated grid (with SEED) before each run's destruction"),
+    VALUE(SAVE_CHECKPOINT, std::string, "", "File to save the burn-in state to (empty=don't save)"),
+    VALUE(LOAD_CHECKPOINT, std::string, "", "Checkpoint every run starts from instead of a burn-in (empty=none)"),
+
+  GROUP(TIMESERIES, "Per-update trajectories of native runs, written next to the CSV as .dyts"),
+    VALUE(TIMESERIES_INTERVAL, int, 0, "Updates between time-series samples (0=off, 1=every update)"),
+    VALUE(TIMESERIES_COMPRESS, int, 1, "Time-series columns: 0=raw int32, 1=delta+varint compressed"),
+
+  GROUP(STOPPING, "Ending native runs before UPDATES; with any rule on, the CSV gains a Stop_Update column"),
+    VALUE(STOP_ON_EXTINCTION, int, 0, "0=never, 1=once every species is extinct (final counts unchanged), 2=once any species is extinct"),
+    VALUE(EQUILIBRIUM_WINDOW, int, 0, "Updates per block of the stationarity test after destruction ends (0=off)"),
+    VALUE(EQUILIBRIUM_TOLERANCE, double, 0.01, "Stop when every species' block mean changes by at most this fraction"),
+
+  GROUP(WEB, "Speed of the web viewer"),
+    VALUE(UPDATES_PER_FRAME, int, 1, "Ecology updates per animation frame (more = fast-forward)"),
+    VALUE(FRAME_BUDGET_MS, double, 12, "Simulation time per frame in milliseconds after which a frame stops updating and draws"),
+    VALUE(RUN_TO_UPDATE, int, 1000, "Update the 'Run to update' button fast-forwards to, as many updates per frame as FRAME_BUDGET_MS allows"),
+
+  GROUP(COMMUNITY, "N-species community of ENGINE 3"),
+    VALUE(COLONIZATION_RATES, std::string, "0.2,0.5", "Colonization rate of each species (list or min:max:step); sets the number of species"),
+    VALUE(EXTINCTION_RATES, std::string, "0.1", "Extinction rate of each species, or one rate for all"),
+    VALUE(COMPETITION_MATRIX, std::string, "", "Rows of 0/1 separated by ';'; entry j of row i is 1 if species i displaces j (empty=hierarchy in list order)")
+  )
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include "emp/math/Random.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Where the ecology updates take their random numbers from
+ */
+enum class RngMode {
+  SHARED = 0, ///< One emp::Random, consumed in processing order (default)
+  COUNTER = 1 ///< CounterRNG, keyed by (seed, update, cell, purpose)
+};
+
+/**
+ * @brief What a keyed random number is used for
+ *
+ * Part of the key, so the draws of one cell in one update are independent.
+ */
+enum class RngPurpose : uint32_t {
+  ORDER = 0,        ///< Fisher-Yates step of the processing order
+  EXTINCTION = 1,   ///< Local extinction test
+  COLONIZATION = 2, ///< Colonization attempt test
+  TARGET = 3        ///< Choice among the valid colonization targets
+};
+
+/**
+ * @brief Counter-based random numbers (Philox4x32-10)
+ *
+ * Every number is a pure function of the key (derived from the run's seed)
+ * and a counter built from (update, cell, purpose), so it does not matter in
+ * which order, or on which thread, the numbers are drawn.  There is no state
+ * to advance or save.  Philox4x32-10 is the generator of Salmon et al.,
+ * "Parallel Random Numbers: As Easy as 1, 2, 3" (SC'11); it passes BigCrush
+ * and costs ten rounds of two 32x32->64 bit multiplies.
+ *
+ * Bernoulli draws are bit-sliced: the 64 cells of a block share a set of
+ * random words, and cell c's draw compares the fixed-point uniform made of
+ * bit (c % 64) of each word with p.  A block of draws costs one Philox call
+ * plus a few word operations per bit of p, and all 64 draws come out at
+ * once as a mask (BernoulliWord), which is what DrawBuffer stores.
+ */
+class CounterRNG {
+public:
+  /// Precision of Bernoulli draws: p is rounded down to a multiple of 2^-32
+  static constexpr int BERNOULLI_BITS = 32;
+
+private:
+  uint32_t key[2] = {0, 0};
+
+  static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53u;
+  static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57u;
+  static constexpr uint32_t WEYL_0 = 0x9E3779B9u;
+  static constexpr uint32_t WEYL_1 = 0xBB67AE85u;
+  /// Set in the second counter word of block draws, which cell draws never reach
+  static constexpr uint32_t BLOCK_FLAG = 0x80000000u;
+
+public:
+  /**
+   * @brief Construct a generator
+   * @param seed Run seed; runs with different seeds get unrelated numbers
+   */
+  explicit CounterRNG(uint64_t seed = 0) { SetSeed(seed); }
+
+  /**
+   * @brief Rekey the generator
+   * @param seed Run seed
+   */
+  void SetSeed(uint64_t seed) {
+    // SplitMix64 finalizer, so nearby seeds give unrelated keys
+    uint64_t z = Mix64(seed + 0x9E3779B97F4A7C15ull);
+    key[0] = static_cast<uint32_t>(z);
+    key[1] = static_cast<uint32_t>(z >> 32);
+  }
+
+  /**
+   * @brief Get 64 random bits
+   * @param update Update the draw belongs to
+   * @param cell Cell (or other per-update index) the draw belongs to
+   * @param purpose What the draw is used for
+   */
+  uint64_t GetBits(uint64_t update, uint64_t cell, RngPurpose purpose) const {
+    uint32_t counter[4] = {static_cast<uint32_t>(cell),
+                           static_cast<uint32_t>(cell >> 32),
+                           static_cast<uint32_t>(update), HighWord(update, purpose)};
+    Philox(counter, key[0], key[1]);
+    return (static_cast<uint64_t>(counter[1]) << 32) | counter[0];
+  }
+
+  /**
+   * @brief Return true with probability p
+   *
+   * Bit (cell % 64) of BernoulliWord for the cell's block.
+   */
+  bool P(double p, uint64_t update, uint64_t cell, RngPurpose purpose) const {
+    return (BernoulliWord(p, update, cell >> 6, purpose) >> (cell & 63)) & 1;
+  }
+
+  /**
+   * @brief Get a uniform integer in [0, max)
+   *
+   * Multiply-shift without rejection; the bias is below max / 2^32.
+   */
+  uint32_t GetUInt(uint32_t max, uint64_t update, uint64_t cell,
+                   RngPurpose purpose) const {
+    return BitsToUInt(GetBits(update, cell, purpose), max);
+  }
+
+  /**
+   * @brief Map GetBits output to [0, max) exactly as GetUInt does
+   */
+  static uint32_t BitsToUInt(uint64_t bits, uint32_t max) {
+    return static_cast<uint32_t>(((bits >> 32) * max) >> 32);
+  }
+
+  /**
+   * @brief Fill a batch with the GetBits values of consecutive cells
+   * @param update Update the draws belong to
+   * @param first_cell Cell of out[0]; out[i] belongs to first_cell + i
+   * @param count Number of values
+   * @param purpose What the draws are used for
+   * @param out Destination
+   *
+   * The iterations are independent and branch-free, so the compiler can
+   * interleave or vectorize the rounds across cells.
+   */
+  void FillBits(uint64_t update, uint64_t first_cell, size_t count,
+                RngPurpose purpose, uint64_t *out) const {
+    const uint32_t update_low = static_cast<uint32_t>(update);
+    const uint32_t high_word = HighWord(update, purpose);
+    for (size_t i = 0; i < count; i++) {
+      uint64_t cell = first_cell + i;
+      uint32_t counter[4] = {static_cast<uint32_t>(cell),
+                             static_cast<uint32_t>(cell >> 32), update_low,
+                             high_word};
+      Philox(counter, key[0], key[1]);
+      out[i] = (static_cast<uint64_t>(counter[1]) << 32) | counter[0];
+    }
+  }
+
+  /**
+   * @brief The Bernoulli draws of the 64 cells of one block
+   * @param p Probability
+   * @param update Update the draws belong to
+   * @param block Block index; bit i is the draw of cell 64 * block + i
+   * @param purpose What the draws are used for
+   */
+  uint64_t BernoulliWord(double p, uint64_t update, uint64_t block,
+                         RngPurpose purpose) const {
+    const uint64_t threshold = Threshold(p);
+    std::array<uint64_t, BERNOULLI_BITS> words;
+    FillSliceWords(update, block, purpose, SliceDepth(threshold), words.data());
+    return SliceCompare(words.data(), threshold);
+  }
+
+  /**
+   * @brief Make the random words one block's Bernoulli draws share
+   * @param update Update the draws belong to
+   * @param block Block index
+   * @param purpose What the draws are used for
+   * @param depth Number of words, most significant first (at most BERNOULLI_BITS)
+   * @param words Destination
+   *
+   * Word j does not depend on depth, so draws of different probabilities
+   * can share the words of the deepest one.
+   */
+  void FillSliceWords(uint64_t update, uint64_t block, RngPurpose purpose,
+                      int depth, uint64_t *words) const {
+    uint32_t counter[4] = {static_cast<uint32_t>(block),
+                           static_cast<uint32_t>(block >> 32) | BLOCK_FLAG,
+                           static_cast<uint32_t>(update), HighWord(update, purpose)};
+    Philox(counter, key[0], key[1]);
+    const uint64_t stream = (static_cast<uint64_t>(counter[1]) << 32) | counter[0];
+    for (int j = 0; j < depth; j++) {
+      words[j] = Mix64(stream + (j + 1) * 0x9E3779B97F4A7C15ull);
+    }
+  }
+
+  /**
+   * @brief p as a fraction of 2^BERNOULLI_BITS, rounded down
+   * @return 0 for p <= 0, 2^BERNOULLI_BITS for p >= 1
+   */
+  static uint64_t Threshold(double p) {
+    if (!(p > 0.0))
+      return 0;
+    if (p >= 1.0)
+      return uint64_t(1) << BERNOULLI_BITS;
+    return static_cast<uint64_t>(p * static_cast<double>(uint64_t(1) << BERNOULLI_BITS));
+  }
+
+  /**
+   * @brief Number of slice words a threshold needs (down to its lowest set bit)
+   */
+  static int SliceDepth(uint64_t threshold) {
+    if (threshold == 0 || (threshold >> BERNOULLI_BITS))
+      return 0;
+    return BERNOULLI_BITS - __builtin_ctzll(threshold);
+  }
+
+  /**
+   * @brief Compare 64 slice uniforms with a threshold at once
+   * @param words Slice words; bit i of words[j] is bit j (from the top) of
+   *        lane i's uniform
+   * @param threshold Threshold from Threshold()
+   * @return Mask of the lanes whose uniform is below the threshold
+   *
+   * Works from the lowest set bit of the threshold upward: a lane is below
+   * if its first differing bit is 0 where the threshold has a 1.
+   */
+  static uint64_t SliceCompare(const uint64_t *words, uint64_t threshold) {
+    if (threshold >> BERNOULLI_BITS)
+      return ~uint64_t(0);
+    uint64_t below = 0;
+    for (int j = SliceDepth(threshold); j-- > 0;) {
+      if ((threshold >> (BERNOULLI_BITS - 1 - j)) & 1)
+        below = ~words[j] | below;
+      else
+        below = ~words[j] & below;
+    }
+    return below;
+  }
+
+private:
+  /**
+   * @brief Last counter word: high update bits and the purpose
+   */
+  static uint32_t HighWord(uint64_t update, RngPurpose purpose) {
+    return (static_cast<uint32_t>(update >> 32) & 0x00FFFFFFu) |
+           (static_cast<uint32_t>(purpose) << 24);
+  }
+
+  /**
+   * @brief SplitMix64 finalizer
+   */
+  static uint64_t Mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  /**
+   * @brief Ten Philox rounds on a 4x32 bit counter, in place
+   *
+   * Works on four scalars rather than an array so the rounds stay in
+   * registers, which is also what lets the batch loops vectorize.
+   */
+  static void Philox(uint32_t counter[4], uint32_t key_0, uint32_t key_1) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    for (int round = 0; round < 10; round++) {
+      uint64_t product_0 = static_cast<uint64_t>(MULTIPLIER_0) * c0;
+      uint64_t product_1 = static_cast<uint64_t>(MULTIPLIER_1) * c2;
+      c0 = static_cast<uint32_t>(product_1 >> 32) ^ c1 ^ key_0;
+      c2 = static_cast<uint32_t>(product_0 >> 32) ^ c3 ^ key_1;
+      c1 = static_cast<uint32_t>(product_1);
+      c3 = static_cast<uint32_t>(product_0);
+      key_0 += WEYL_0;
+      key_1 += WEYL_1;
+    }
+    counter[0] = c0;
+    counter[1] = c1;
+    counter[2] = c2;
+    counter[3] = c3;
+  }
+};
+
+/**
+ * @brief Draw interface over the shared emp::Random
+ *
+ * The ecology code draws through StreamDraws or KeyedDraws, so one
+ * implementation serves both RNG modes.  StreamDraws ignores the key and
+ * consumes the generator in call order, exactly like direct calls.
+ */
+struct StreamDraws {
+  emp::Random &random;
+
+  bool P(double p, uint64_t, RngPurpose) { return random.P(p); }
+  size_t GetUInt(size_t max, uint64_t, RngPurpose) { return random.GetUInt(max); }
+};
+
+/**
+ * @brief Draw interface over a CounterRNG for one update
+ */
+struct KeyedDraws {
+  const CounterRNG &rng;
+  uint64_t update;
+
+  bool P(double p, uint64_t cell, RngPurpose purpose) {
+    return rng.P(p, update, cell, purpose);
+  }
+  size_t GetUInt(size_t max, uint64_t cell, RngPurpose purpose) {
+    return rng.GetUInt(static_cast<uint32_t>(max), update, cell, purpose);
+  }
+};
+
+#endif
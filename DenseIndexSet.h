@@ -0,0 +1,76 @@
+#ifndef DENSE_INDEX_SET_H
+#define DENSE_INDEX_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Set of cell indices with O(1) insert, erase and membership
+ *
+ * Members are kept packed in an array, so iterating costs the number of
+ * members, not the number of cells.  Erasing moves the last member into the
+ * freed slot, so the iteration order is arbitrary.  A slot index per cell
+ * (4 bytes) tracks where each member is.
+ */
+class DenseIndexSet {
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  std::vector<size_t> members;  ///< The members, packed
+  std::vector<uint32_t> slots;  ///< Slot of each cell in members, or NONE
+
+public:
+  using const_iterator = std::vector<size_t>::const_iterator;
+
+  /**
+   * @brief Set the number of cells and remove every member
+   */
+  void Resize(size_t num_cells) {
+    members.clear();
+    slots.assign(num_cells, NONE);
+  }
+
+  /**
+   * @brief Remove every member, keeping the number of cells
+   */
+  void Clear() {
+    for (size_t pos : members) {
+      slots[pos] = NONE;
+    }
+    members.clear();
+  }
+
+  size_t GetSize() const { return members.size(); }
+  bool IsEmpty() const { return members.empty(); }
+  bool Has(size_t pos) const { return slots[pos] != NONE; }
+
+  /**
+   * @brief Add a cell; does nothing if it is already a member
+   */
+  void Insert(size_t pos) {
+    if (slots[pos] != NONE)
+      return;
+    slots[pos] = static_cast<uint32_t>(members.size());
+    members.push_back(pos);
+  }
+
+  /**
+   * @brief Remove a cell; does nothing if it is not a member
+   */
+  void Erase(size_t pos) {
+    uint32_t slot = slots[pos];
+    if (slot == NONE)
+      return;
+    size_t last = members.back();
+    members[slot] = last;
+    slots[last] = slot;
+    members.pop_back();
+    slots[pos] = NONE;
+  }
+
+  const_iterator begin() const { return members.begin(); }
+  const_iterator end() const { return members.end(); }
+};
+
+#endif
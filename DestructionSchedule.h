@@ -0,0 +1,126 @@
+#ifndef DESTRUCTION_SCHEDULE_H
+#define DESTRUCTION_SCHEDULE_H
+
+#include <algorithm>
+#include <utility>
+
+#include "emp/base/vector.hpp"
+
+/**
+ * @brief Schedule for incremental habitat destruction
+ *
+ * Holds the precomputed, pre-shuffled order in which cells are destroyed
+ * and a cursor marking how much of it has been applied.  Round r covers
+ * order[RoundStart(r), RoundStart(r + 1)); as in the original queue, the
+ * first (size % rounds) rounds each destroy one extra cell.  Advancing a
+ * round is O(cells in that round) and seeking to any round is O(1).
+ */
+class DestructionSchedule {
+private:
+  emp::vector<size_t> order; ///< Cells in the order they are destroyed
+  size_t cursor = 0;         ///< Number of cells of order already destroyed
+  int total_rounds = 0;      ///< Number of rounds destruction is spread over
+  int current_round = 0;     ///< Number of rounds already processed
+
+public:
+  /**
+   * @brief Replace the schedule
+   * @param cells Cells to destroy, in destruction order
+   * @param rounds Number of rounds to spread them over
+   */
+  void Reset(emp::vector<size_t> cells, int rounds) {
+    order = std::move(cells);
+    cursor = 0;
+    total_rounds = std::max(0, rounds);
+    current_round = 0;
+  }
+
+  /**
+   * @brief Remove all scheduled destruction
+   */
+  void Clear() { Reset(emp::vector<size_t>(), 0); }
+
+  /**
+   * @brief Check if there are rounds left to process
+   */
+  bool IsActive() const { return current_round < total_rounds; }
+
+  /**
+   * @brief Get the number of rounds already processed
+   */
+  int GetRound() const { return current_round; }
+
+  /**
+   * @brief Get the number of rounds destruction is spread over
+   */
+  int GetTotalRounds() const { return total_rounds; }
+
+  /**
+   * @brief Get the number of rounds left to process
+   */
+  int GetRoundsRemaining() const { return total_rounds - current_round; }
+
+  /**
+   * @brief Get the full destruction order
+   */
+  const emp::vector<size_t> &GetOrder() const { return order; }
+
+  /**
+   * @brief Get the number of cells already destroyed by the schedule
+   */
+  size_t GetCursor() const { return cursor; }
+
+  /**
+   * @brief Get the number of cells still waiting to be destroyed
+   */
+  size_t GetNumRemaining() const { return order.size() - cursor; }
+
+  /**
+   * @brief Get the cells still waiting to be destroyed, in order
+   * @return Pointers to the first and one-past-last remaining cell
+   */
+  std::pair<const size_t *, const size_t *> GetRemaining() const {
+    return {order.data() + cursor, order.data() + order.size()};
+  }
+
+  /**
+   * @brief Get the index into the order where a round starts
+   * @param round Round number in [0, total rounds]
+   * @return Offset of the round's first cell
+   */
+  size_t RoundStart(int round) const {
+    if (total_rounds == 0)
+      return 0;
+    size_t r = static_cast<size_t>(std::clamp(round, 0, total_rounds));
+    size_t cells_per_round = order.size() / total_rounds;
+    size_t extra_cells = order.size() % total_rounds;
+    return r * cells_per_round + std::min(r, extra_cells);
+  }
+
+  /**
+   * @brief Advance by one round
+   * @return Range [first, last) of order indices destroyed this round
+   */
+  std::pair<size_t, size_t> NextRound() {
+    if (!IsActive())
+      return {cursor, cursor};
+    size_t first = cursor;
+    current_round++;
+    cursor = RoundStart(current_round);
+    return {first, cursor};
+  }
+
+  /**
+   * @brief Move the cursor to the start of a round
+   * @param round Round number in [0, total rounds]
+   * @return Previous cursor; cells between it and the new cursor changed state
+   */
+  size_t SeekRound(int round) {
+    size_t previous = cursor;
+    current_round = std::clamp(round, 0, total_rounds);
+    cursor = RoundStart(current_round);
+    return previous;
+  }
+};
+
+#endif
@@ -0,0 +1,385 @@
+#ifndef GILLESPIE_WORLD_H
+#define GILLESPIE_WORLD_H
+
+#include "emp/math/Random.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "CompactWorld.h"
+
+/**
+ * @brief Event-driven engine for a continuous-time version of the C/D model
+ *
+ * This is a different model from the discrete engines, not another way of
+ * running it.  Each organism of species s goes extinct at rate e and
+ * attempts colonization at rate c * (1 - e), where e and c are the
+ * per-update probabilities of the discrete engines, using the same target
+ * rules as TryColonize (one random valid neighbour; C displaces D, D only
+ * takes empty cells).  In a discrete update only survivors colonize, so
+ * c * (1 - e) is the expected number of attempts per organism and update;
+ * with these rates both models have the same mean-field equilibrium.  The
+ * spatial and within-update ordering effects differ, so counts differ
+ * systematically: on a 50x50 grid ENGINE 2 ends with about 1% fewer C at
+ * 0% destroyed and about 3% fewer at 50%.
+ *
+ * Instead of visiting every occupied cell each update, the engine draws
+ * the time to the next event from the total rate, picks the event type
+ * from the per-species rate totals and the organism uniformly from a dense
+ * per-species list, so the work is proportional to the number of events
+ * that actually happen.
+ *
+ * Grid state, habitat destruction and the initial population are kept in a
+ * CompactWorld, so setup consumes random numbers exactly like the compact
+ * engine.  One unit of time corresponds to one update: UpdateEcology
+ * advances the clock by 1 and incremental destruction rounds are applied at
+ * integer times, so the engine drops into RunExperiment unchanged.
+ */
+class GillespieWorld {
+private:
+  emp::Random &random;
+  CompactWorld grid; ///< Cell states, neighbourhood and destruction schedule
+
+  /// Occupied cells of each species, in no particular order
+  std::array<std::vector<uint32_t>, 2> members;
+  /// Index of each occupied cell in its species' member list
+  std::vector<uint32_t> member_index;
+  size_t num_destroyed = 0;
+
+  double time = 0.0; ///< Continuous time since InitializeGrid
+
+  // Event counters, cumulative since InitializeGrid
+  uint64_t extinction_events = 0;   ///< Organisms lost to local extinction
+  uint64_t colonization_events = 0; ///< Successful colonizations
+
+public:
+  /**
+   * @brief Construct a new GillespieWorld
+   * @param _random Reference to random number generator
+   */
+  GillespieWorld(emp::Random &_random) : random(_random), grid(_random) {}
+
+  /**
+   * @brief Initialize the world with a grid structure
+   * @param width Grid width
+   * @param height Grid height
+   */
+  void InitializeGrid(int width, int height) {
+    grid.InitializeGrid(width, height);
+    time = 0.0;
+    extinction_events = 0;
+    colonization_events = 0;
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Initialize the grid on an external habitat mask (see CompactWorld)
+   */
+  void InitializeGrid(std::shared_ptr<const HabitatMask> mask) {
+    grid.InitializeGrid(std::move(mask));
+    time = 0.0;
+    extinction_events = 0;
+    colonization_events = 0;
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Set the habitat mask without touching any cell (see CompactWorld)
+   */
+  void SetHabitatMask(std::shared_ptr<const HabitatMask> mask) {
+    grid.SetHabitatMask(std::move(mask));
+  }
+
+  /**
+   * @brief Choose the colonization neighbourhood (see CompactWorld)
+   */
+  void SetNeighborhood(NeighborhoodType type, bool wrap) {
+    grid.SetNeighborhood(type, wrap);
+  }
+
+  NeighborhoodType GetNeighborhoodType() const { return grid.GetNeighborhoodType(); }
+  bool GetWrapEdges() const { return grid.GetWrapEdges(); }
+
+  /**
+   * @brief Get the underlying cell grid
+   */
+  const CompactWorld &GetGrid() const { return grid; }
+
+  size_t GetSize() const { return grid.GetSize(); }
+  int GetWidth() const { return grid.GetWidth(); }
+  int GetHeight() const { return grid.GetHeight(); }
+  CellState GetState(size_t pos) const { return grid.GetState(pos); }
+  bool IsOccupied(size_t pos) const { return grid.IsOccupied(pos); }
+  bool IsDestroyed(size_t pos) const { return grid.IsDestroyed(pos); }
+
+  /**
+   * @brief Get the current continuous time
+   */
+  double GetTime() const { return time; }
+
+  /**
+   * @brief Place an organism of the given species in an empty cell
+   * @param species Species identifier (0=c, 1=d)
+   * @param pos Position to place it at
+   */
+  void AddOrgAt(int species, size_t pos) {
+    RemoveOrganism(pos);
+    grid.AddOrgAt(species, pos);
+    AddMember(species, pos);
+  }
+
+  /**
+   * @brief Remove organism from the world
+   * @param pos Position index
+   */
+  void RemoveOrganism(size_t pos) {
+    if (grid.IsOccupied(pos)) {
+      RemoveMember(grid.GetSpecies(pos), pos);
+      grid.RemoveOrganism(pos);
+    }
+  }
+
+  /**
+   * @brief Destroy a cell, killing any occupant
+   * @param pos Position to destroy
+   */
+  void DestroyCell(size_t pos) {
+    if (!grid.IsDestroyed(pos)) {
+      RemoveOrganism(pos);
+      grid.DestroyCell(pos);
+      num_destroyed++;
+    }
+  }
+
+  /**
+   * @brief Return every cell to empty, intact habitat
+   */
+  void ClearGrid() {
+    grid.ClearGrid();
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Initialize habitat destruction (see CompactWorld)
+   */
+  void InitializeIncrementalDestruction(double destruction_percentage, int rounds,
+                                        int pattern) {
+    grid.InitializeIncrementalDestruction(destruction_percentage, rounds, pattern);
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Initialize habitat destruction from a generated landscape
+   */
+  void InitializeIncrementalDestruction(emp::vector<size_t> order, int rounds) {
+    grid.InitializeIncrementalDestruction(std::move(order), rounds);
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Apply the next round of incremental destruction now
+   * @return Number of cells destroyed this round
+   */
+  int ProcessIncrementalDestruction() {
+    const DestructionSchedule &schedule = grid.GetDestructionSchedule();
+    if (!schedule.IsActive())
+      return 0;
+    const emp::vector<size_t> &order = schedule.GetOrder();
+    size_t first = schedule.GetCursor();
+    size_t last = schedule.RoundStart(schedule.GetRound() + 1);
+    for (size_t i = first; i < last; i++) {
+      RemoveOrganism(order[i]);
+    }
+    num_destroyed += last - first;
+    return grid.ProcessIncrementalDestruction();
+  }
+
+  /**
+   * @brief Restore a destruction schedule without touching any cell
+   */
+  void RestoreDestructionSchedule(emp::vector<size_t> order, int total_rounds,
+                                  int round) {
+    grid.RestoreDestructionSchedule(std::move(order), total_rounds, round);
+  }
+
+  const DestructionSchedule &GetDestructionSchedule() const {
+    return grid.GetDestructionSchedule();
+  }
+
+  bool IsIncrementalDestructionActive() const {
+    return grid.IsIncrementalDestructionActive();
+  }
+
+  /**
+   * @brief Populate like CompactWorld::PopulateWithBothSpecies
+   */
+  void PopulateWithBothSpecies(double initial_occupancy) {
+    grid.PopulateWithBothSpecies(initial_occupancy);
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Populate like CompactWorld::PopulateWithSpeciesD
+   */
+  void PopulateWithSpeciesD(double initial_occupancy) {
+    grid.PopulateWithSpeciesD(initial_occupancy);
+    RebuildMembers();
+  }
+
+  /**
+   * @brief Advance the clock by one unit of time (one update)
+   */
+  void UpdateEcology() { AdvanceTo(time + 1.0); }
+
+  /**
+   * @brief Run events until a given time
+   * @param end_time Time to stop at; the state is then the state at end_time
+   *
+   * Incremental destruction is not applied here; callers sampling at
+   * non-integer times apply ProcessIncrementalDestruction at integer times.
+   */
+  void AdvanceTo(double end_time) {
+    while (true) {
+      // Per-species totals of the two event types
+      std::array<double, 4> rates;
+      double total_rate = 0.0;
+      for (int species = 0; species < 2; species++) {
+        const SpeciesParams &params = grid.GetSpeciesParams(species);
+        double count = static_cast<double>(members[species].size());
+        rates[2 * species] = count * params.extinction_rate;
+        rates[2 * species + 1] =
+            count * params.colonization_rate * (1.0 - params.extinction_rate);
+        total_rate += rates[2 * species] + rates[2 * species + 1];
+      }
+      if (total_rate <= 0.0)
+        break;
+
+      // Exponential waiting time; the process is memoryless, so an event
+      // past end_time can simply be discarded
+      double wait = -std::log(1.0 - random.GetDouble()) / total_rate;
+      if (time + wait > end_time)
+        break;
+      time += wait;
+
+      double pick = random.GetDouble() * total_rate;
+      int event = 0;
+      while (event < 3 && pick >= rates[event]) {
+        pick -= rates[event];
+        event++;
+      }
+      int species = event / 2;
+      const std::vector<uint32_t> &list = members[species];
+      size_t pos = list[random.GetUInt(list.size())];
+
+      if (event % 2 == 0) {
+        RemoveOrganism(pos);
+        extinction_events++;
+      } else {
+        Colonize(pos);
+      }
+    }
+    time = end_time;
+  }
+
+  /**
+   * @brief Count organisms of each species in O(1)
+   * @return Array with counts [species_c, species_d, empty, destroyed]
+   */
+  std::array<int, 4> CountCells() const {
+    int species_c = static_cast<int>(members[0].size());
+    int species_d = static_cast<int>(members[1].size());
+    int destroyed = static_cast<int>(num_destroyed);
+    int empty = static_cast<int>(grid.GetSize()) - species_c - species_d - destroyed;
+    return {species_c, species_d, empty, destroyed};
+  }
+
+  /**
+   * @brief Count the cells of one grid column (see CompactWorld)
+   */
+  std::array<int, 4> CountColumn(int col) const { return grid.CountColumn(col); }
+
+  /**
+   * @brief Get the number of local extinctions since InitializeGrid
+   */
+  uint64_t GetExtinctionEvents() const { return extinction_events; }
+
+  /**
+   * @brief Get the number of successful colonizations since InitializeGrid
+   */
+  uint64_t GetColonizationEvents() const { return colonization_events; }
+
+  /**
+   * @brief Overwrite the cumulative event counters (used by checkpoints)
+   */
+  void SetEventCounts(uint64_t extinctions, uint64_t colonizations) {
+    extinction_events = extinctions;
+    colonization_events = colonizations;
+  }
+
+  /**
+   * @brief Accepted for parity with the discrete engines (used by
+   *        checkpoints); event times do not depend on the update count
+   */
+  void SetEcologyUpdates(uint64_t updates) { grid.SetEcologyUpdates(updates); }
+
+private:
+  /**
+   * @brief Colonization attempt by the organism at pos
+   *
+   * Same target rules as CompactWorld::TryColonize, without the rate draw
+   * (the event itself is the attempt).
+   */
+  void Colonize(size_t pos) {
+    int colonizer = grid.GetSpecies(pos);
+    const uint64_t open = CompactWorld::Species::OpenStates(colonizer);
+    std::array<size_t, Neighborhood::MAX_NEIGHBORS> valid_targets;
+    size_t num_targets = 0;
+
+    for (size_t neighbor_pos : grid.GetNeighbors(pos)) {
+      if ((open >> grid.GetState(neighbor_pos)) & 1) {
+        valid_targets[num_targets++] = neighbor_pos;
+      }
+    }
+    if (num_targets == 0)
+      return;
+
+    AddOrgAt(colonizer, valid_targets[random.GetUInt(num_targets)]);
+    colonization_events++;
+  }
+
+  void AddMember(int species, size_t pos) {
+    member_index[pos] = static_cast<uint32_t>(members[species].size());
+    members[species].push_back(static_cast<uint32_t>(pos));
+  }
+
+  /**
+   * @brief Swap-remove a cell from its species' member list
+   */
+  void RemoveMember(int species, size_t pos) {
+    std::vector<uint32_t> &list = members[species];
+    uint32_t index = member_index[pos];
+    list[index] = list.back();
+    member_index[list[index]] = index;
+    list.pop_back();
+  }
+
+  /**
+   * @brief Rebuild the member lists and destroyed count from the grid
+   */
+  void RebuildMembers() {
+    members[0].clear();
+    members[1].clear();
+    member_index.assign(grid.GetSize(), 0);
+    num_destroyed = 0;
+    for (size_t pos = 0; pos < grid.GetSize(); pos++) {
+      if (grid.IsOccupied(pos)) {
+        AddMember(grid.GetSpecies(pos), pos);
+      } else if (grid.IsDestroyed(pos)) {
+        num_destroyed++;
+      }
+    }
+  }
+};
+
+#endif
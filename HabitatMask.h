@@ -0,0 +1,255 @@
+#ifndef HABITAT_MASK_H
+#define HABITAT_MASK_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Read-only, memory-mapped map of habitat and non-habitat cells
+ *
+ * Supported files:
+ * - Binary PGM (P5, maxval up to 255): one byte per cell, 0 = destroyed
+ * - Binary PBM (P4): one bit per cell, rows padded to a byte, 1 (black) = destroyed
+ * - Raw bytes with no header: one byte per cell in row-major order,
+ *   0 = destroyed; the grid size must be given, and the file must be exactly
+ *   width * height bytes
+ *
+ * Opening a mask reads only its header; cells are read from the mapping
+ * when a world fills its destroyed cells from it, and pages come straight
+ * from the page cache.  The mask is immutable, so one mapping can be shared
+ * through a std::shared_ptr by any number of worlds and threads.
+ */
+class HabitatMask {
+public:
+  enum class Format { PGM, PBM, RAW };
+
+private:
+  const uint8_t *map = nullptr; ///< Whole file
+  size_t map_size = 0;
+  const uint8_t *pixels = nullptr; ///< First byte of cell data
+  size_t row_bytes = 0;            ///< Bytes per row of cell data
+  int width = 0;
+  int height = 0;
+  Format format = Format::RAW;
+
+  HabitatMask() = default;
+
+public:
+  HabitatMask(const HabitatMask &) = delete;
+  HabitatMask &operator=(const HabitatMask &) = delete;
+
+  ~HabitatMask() {
+    if (map)
+      munmap(const_cast<uint8_t *>(map), map_size);
+  }
+
+  /**
+   * @brief Map a mask file
+   * @param path File to map
+   * @param raw_width Grid width, used only for raw files
+   * @param raw_height Grid height, used only for raw files
+   * @param error Set to a description of the problem on failure
+   * @return The mask, or null if the file cannot be mapped or is malformed
+   */
+  static std::shared_ptr<const HabitatMask> Open(const std::string &path, int raw_width,
+                                                 int raw_height, std::string &error) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      error = "Cannot open " + path;
+      return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+      close(fd);
+      error = path + " is empty";
+      return nullptr;
+    }
+    void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      error = "Cannot map " + path;
+      return nullptr;
+    }
+
+    std::shared_ptr<HabitatMask> mask(new HabitatMask());
+    mask->map = static_cast<const uint8_t *>(data);
+    mask->map_size = static_cast<size_t>(info.st_size);
+    if (!mask->ParseHeader(raw_width, raw_height, error)) {
+      error = path + ": " + error;
+      return nullptr;
+    }
+    return mask;
+  }
+
+  int GetWidth() const { return width; }
+  int GetHeight() const { return height; }
+  size_t GetSize() const { return static_cast<size_t>(width) * height; }
+  Format GetFormat() const { return format; }
+
+  /**
+   * @brief Check whether a cell is non-habitat
+   * @param pos Row-major cell index
+   */
+  bool IsDestroyed(size_t pos) const {
+    size_t row = pos / width, col = pos % width;
+    const uint8_t *line = pixels + row * row_bytes;
+    if (format == Format::PBM)
+      return (line[col >> 3] >> (7 - (col & 7))) & 1;
+    return line[col] == 0;
+  }
+
+  /**
+   * @brief Write the non-habitat cells as a packed plane
+   * @param words ceil(GetSize() / 64) words; bit i of the plane is cell i, as
+   *        in Bitplane, and bits past the last cell are cleared
+   */
+  void FillDestroyedWords(uint64_t *words) const {
+    const size_t num_cells = GetSize();
+    const size_t num_words = (num_cells + 63) / 64;
+    std::fill(words, words + num_words, 0);
+    if (format != Format::PBM) {
+      // Rows are contiguous: 8 bytes at a time, zero bytes to bits (the
+      // mapping is read as little-endian words)
+      for (size_t w = 0; w < num_cells / 64; w++) {
+        uint64_t bits = 0;
+        for (size_t part = 0; part < 8; part++) {
+          uint64_t bytes;
+          std::memcpy(&bytes, pixels + w * 64 + part * 8, 8);
+          bits |= ZeroBytes(bytes) << (part * 8);
+        }
+        words[w] = bits;
+      }
+      for (size_t pos = num_cells / 64 * 64; pos < num_cells; pos++) {
+        words[pos >> 6] |= uint64_t(pixels[pos] == 0) << (pos & 63);
+      }
+      return;
+    }
+    if (width % 8 == 0) {
+      // No row padding: each byte is 8 cells in reversed bit order
+      for (size_t byte = 0; byte < num_cells / 8; byte++) {
+        words[byte >> 3] |= uint64_t(ReverseBits(pixels[byte])) << ((byte & 7) * 8);
+      }
+      return;
+    }
+    for (int row = 0; row < height; row++) {
+      const uint8_t *line = pixels + static_cast<size_t>(row) * row_bytes;
+      size_t pos = static_cast<size_t>(row) * width;
+      for (int col = 0; col < width; col++, pos++) {
+        uint64_t destroyed = (line[col >> 3] >> (7 - (col & 7))) & 1;
+        words[pos >> 6] |= destroyed << (pos & 63);
+      }
+    }
+  }
+
+  /**
+   * @brief Drop the non-habitat cells from a list of cells, keeping the order
+   * @param cells Row-major cell indices, e.g. a destruction landscape
+   */
+  template <typename VECTOR> void RemoveDestroyed(VECTOR &cells) const {
+    cells.erase(std::remove_if(cells.begin(), cells.end(),
+                               [this](size_t pos) { return IsDestroyed(pos); }),
+                cells.end());
+  }
+
+private:
+  /**
+   * @brief One bit per zero byte of a little-endian word: bit i for byte i
+   */
+  static uint64_t ZeroBytes(uint64_t bytes) {
+    constexpr uint64_t LOW7 = 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t zero = ~(((bytes & LOW7) + LOW7) | bytes | LOW7); // High bit of zero bytes
+    return ((zero >> 7) * 0x0102040810204080ULL) >> 56;
+  }
+
+  /**
+   * @brief Reverse the bit order of a byte (PBM stores the leftmost cell in bit 7)
+   */
+  static uint8_t ReverseBits(uint8_t byte) {
+    byte = static_cast<uint8_t>((byte & 0xF0) >> 4 | (byte & 0x0F) << 4);
+    byte = static_cast<uint8_t>((byte & 0xCC) >> 2 | (byte & 0x33) << 2);
+    return static_cast<uint8_t>((byte & 0xAA) >> 1 | (byte & 0x55) << 1);
+  }
+
+  /**
+   * @brief Find the format, size and cell data of the mapped file
+   */
+  bool ParseHeader(int raw_width, int raw_height, std::string &error) {
+    size_t offset = 0;
+    if (map_size >= 2 && map[0] == 'P' && (map[1] == '4' || map[1] == '5')) {
+      format = map[1] == '4' ? Format::PBM : Format::PGM;
+      offset = 2;
+      long maxval = 1;
+      if (!ReadHeaderInt(offset, width) || !ReadHeaderInt(offset, height) ||
+          (format == Format::PGM && !ReadHeaderLong(offset, maxval))) {
+        error = "malformed PNM header";
+        return false;
+      }
+      if (maxval < 1 || maxval > 255) {
+        error = "only 8-bit PGM files are supported";
+        return false;
+      }
+      offset++; // Single whitespace byte before the data
+      row_bytes = format == Format::PBM ? (static_cast<size_t>(width) + 7) / 8 : width;
+    } else {
+      format = Format::RAW;
+      width = raw_width;
+      height = raw_height;
+      row_bytes = width;
+      if (static_cast<size_t>(width) * height != map_size) {
+        error = "raw mask has " + std::to_string(map_size) + " bytes, not " +
+                std::to_string(static_cast<size_t>(width) * height) +
+                " (GRID_WIDTH x GRID_HEIGHT)";
+        return false;
+      }
+    }
+    if (width <= 0 || height <= 0 || offset + row_bytes * height > map_size) {
+      error = "mask data is truncated";
+      return false;
+    }
+    pixels = map + offset;
+    return true;
+  }
+
+  /**
+   * @brief Read one whitespace-separated header number, skipping # comments
+   */
+  bool ReadHeaderLong(size_t &offset, long &value) const {
+    while (offset < map_size) {
+      if (map[offset] == '#') {
+        while (offset < map_size && map[offset] != '\n')
+          offset++;
+      } else if (std::isspace(map[offset])) {
+        offset++;
+      } else {
+        break;
+      }
+    }
+    if (offset >= map_size || !std::isdigit(map[offset]))
+      return false;
+    value = 0;
+    while (offset < map_size && std::isdigit(map[offset]) && value < (1L << 30)) {
+      value = value * 10 + (map[offset++] - '0');
+    }
+    return true;
+  }
+
+  bool ReadHeaderInt(size_t &offset, int &value) const {
+    long parsed = 0;
+    if (!ReadHeaderLong(offset, parsed) || parsed > (1L << 24))
+      return false;
+    value = static_cast<int>(parsed);
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef LANDSCAPE_H
+#define LANDSCAPE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "HabitatMask.h"
+
+/**
+ * @brief Spatial arrangement of destroyed habitat
+ */
+enum class LandscapePattern {
+  RANDOM = 0,     ///< Exactly the target number of cells, uniformly at random
+  GRADIENT = 1,   ///< Linear left-to-right gradient of destruction probability
+  CLUMPED = 2,    ///< Fractal clumps: the highest cells of a 1/f noise field
+  PERCOLATION = 3 ///< One invasion-percolation cluster grown from a random cell
+};
+
+/// Number of LandscapePattern values; DESTRUCTION_PATTERN is in [0, this)
+constexpr int NUM_LANDSCAPE_PATTERNS = 4;
+
+/**
+ * @brief Get the display name of a destruction pattern
+ */
+inline std::string LandscapePatternName(int pattern) {
+  switch (static_cast<LandscapePattern>(pattern)) {
+  case LandscapePattern::RANDOM: return "Random";
+  case LandscapePattern::GRADIENT: return "Gradient";
+  case LandscapePattern::CLUMPED: return "Clumped";
+  case LandscapePattern::PERCOLATION: return "Percolation";
+  }
+  return "Unknown";
+}
+
+/**
+ * @brief Generates destruction landscapes in O(cells)
+ *
+ * A landscape is the list of cells to destroy in the order they are
+ * destroyed.  Immediate destruction destroys the whole list; incremental
+ * destruction hands it to a DestructionSchedule, so both use the same
+ * generator and the state after the last round equals the immediate one.
+ * Every engine calls Generate with its own generator (or uses a cached
+ * landscape), so engines given the same random stream destroy the same cells.
+ *
+ * With a habitat mask, the fraction is a fraction of the habitat cells and
+ * the landscape never lists a non-habitat cell.  RANDOM shuffles only the
+ * habitat cells.  CLUMPED and PERCOLATION still rank the whole grid and
+ * keep drawing past non-habitat cells until they have the target number of
+ * habitat cells.  GRADIENT skips them and scales its column probabilities
+ * so that the expected share of habitat destroyed is that of the unmasked
+ * grid.
+ */
+class LandscapeGenerator {
+public:
+  /// Hurst exponent of the CLUMPED field; higher gives larger, smoother clumps
+  static constexpr double CLUMPED_HURST = 0.8;
+  /// Distinct invasion thresholds of the PERCOLATION pattern
+  static constexpr uint32_t PERCOLATION_LEVELS = 256;
+
+  /**
+   * @brief Generate a landscape
+   * @param pattern Destruction pattern (a LandscapePattern value)
+   * @param fraction Fraction of cells to destroy (0.0 to 1.0); the mean for GRADIENT
+   * @param width Grid width
+   * @param height Grid height
+   * @param random Generator the landscape is drawn from
+   * @param mask Non-habitat cells, which are never listed (nullptr = none)
+   * @return Cells in destruction order
+   */
+  static emp::vector<size_t> Generate(int pattern, double fraction, int width,
+                                      int height, emp::Random &random,
+                                      const HabitatMask *mask = nullptr) {
+    switch (static_cast<LandscapePattern>(pattern)) {
+    case LandscapePattern::GRADIENT:
+      return GradientOrder(fraction, width, height, random, mask);
+    case LandscapePattern::CLUMPED:
+      return ClumpedOrder(fraction, width, height, random, mask);
+    case LandscapePattern::PERCOLATION:
+      return PercolationOrder(fraction, width, height, random, mask);
+    default:
+      return RandomOrder(fraction, width, height, random, mask);
+    }
+  }
+
+  /**
+   * @brief Number of cells the exact-count patterns destroy
+   */
+  static size_t TargetCount(size_t total_cells, double fraction) {
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    return static_cast<size_t>(total_cells * fraction);
+  }
+
+  /**
+   * @brief Compute the left/right destruction probabilities of the gradient
+   * @param fraction Average fraction destroyed
+   * @param max_destruction Set to the leftmost column's probability
+   * @param min_destruction Set to the rightmost column's probability
+   *
+   * The two ends are 0.5 apart around the mean (0.75 and 0.25 for 0.5),
+   * shifted inward when one end would leave [0, 1].
+   */
+  static void GradientRange(double fraction, double &max_destruction,
+                            double &min_destruction) {
+    double spread = 0.5;
+    max_destruction = fraction + (spread / 2.0);
+    min_destruction = fraction - (spread / 2.0);
+
+    if (max_destruction > 1.0) {
+      double excess = max_destruction - 1.0;
+      max_destruction = 1.0;
+      min_destruction = std::max(0.0, min_destruction - excess);
+    }
+    if (min_destruction < 0.0) {
+      double deficit = -min_destruction;
+      min_destruction = 0.0;
+      max_destruction = std::min(1.0, max_destruction + deficit);
+    }
+  }
+
+private:
+  /**
+   * @brief Exact-count random destruction by a partial Fisher-Yates shuffle
+   *
+   * Only the first TargetCount positions are shuffled.  For one random
+   * stream the landscape at a lower fraction is a prefix of the one at a
+   * higher fraction.
+   */
+  static emp::vector<size_t> RandomOrder(double fraction, int width, int height,
+                                         emp::Random &random, const HabitatMask *mask) {
+    const size_t total_cells = static_cast<size_t>(width) * height;
+    emp::vector<size_t> order(total_cells);
+    std::iota(order.begin(), order.end(), size_t(0));
+    if (mask)
+      mask->RemoveDestroyed(order);
+    const size_t num_habitat = order.size();
+    const size_t target = TargetCount(num_habitat, fraction);
+    for (size_t i = 0; i < target; i++) {
+      size_t j = i + random.GetUInt(num_habitat - i);
+      std::swap(order[i], order[j]);
+    }
+    order.resize(target);
+    return order;
+  }
+
+  /**
+   * @brief Each cell destroyed with its column's probability, then shuffled
+   *
+   * The probability falls linearly from the left column to the right one,
+   * so the destroyed count is binomial around fraction * cells.  With a
+   * mask, non-habitat cells are not drawn for and the column probabilities
+   * are scaled by one factor (capped at 1) so that the expected share of
+   * habitat destroyed is the unmasked grid's; a mask spread evenly over the
+   * columns leaves them unchanged.
+   */
+  static emp::vector<size_t> GradientOrder(double fraction, int width, int height,
+                                           emp::Random &random, const HabitatMask *mask) {
+    double max_destruction, min_destruction;
+    GradientRange(fraction, max_destruction, min_destruction);
+
+    std::vector<double> column_prob(width);
+    for (int col = 0; col < width; col++) {
+      column_prob[col] = width > 1
+          ? max_destruction - (col * (max_destruction - min_destruction) / (width - 1))
+          : fraction;
+    }
+    if (mask) {
+      std::vector<size_t> column_habitat(width, 0);
+      for (size_t pos = 0; pos < mask->GetSize(); pos++) {
+        column_habitat[pos % width] += !mask->IsDestroyed(pos);
+      }
+      double grid_expected = 0.0, habitat_expected = 0.0;
+      size_t num_habitat = 0;
+      for (int col = 0; col < width; col++) {
+        grid_expected += column_prob[col] * height;
+        habitat_expected += column_prob[col] * column_habitat[col];
+        num_habitat += column_habitat[col];
+      }
+      const double target = grid_expected / (static_cast<double>(width) * height) * num_habitat;
+      const double scale = habitat_expected > 0.0 ? target / habitat_expected : 0.0;
+      for (double &prob : column_prob) {
+        prob = std::min(1.0, prob * scale);
+      }
+    }
+
+    emp::vector<size_t> order;
+    for (int col = 0; col < width; col++) {
+      for (int row = 0; row < height; row++) {
+        const size_t pos = static_cast<size_t>(row) * width + col;
+        if (mask && mask->IsDestroyed(pos))
+          continue;
+        if (random.P(column_prob[col])) {
+          order.push_back(pos);
+        }
+      }
+    }
+    Shuffle(order, random);
+    return order;
+  }
+
+  /**
+   * @brief Destroy the highest cells of a fractal noise field
+   *
+   * The field is built coarse to fine: each level is the bilinear upsampling
+   * of the level above plus white noise of amplitude 2^(level * H).  This is
+   * spectral synthesis of 1/f^(2H+2) noise in the spatial domain; the levels
+   * shrink by 4x, so the whole pyramid costs 4/3 of the grid.  Cells are
+   * ranked by a counting sort, and the highest are destroyed first, so
+   * incremental destruction grows the clumps.
+   */
+  static emp::vector<size_t> ClumpedOrder(double fraction, int width, int height,
+                                          emp::Random &random, const HabitatMask *mask) {
+    const size_t total_cells = static_cast<size_t>(width) * height;
+    const std::vector<float> field = FractalField(width, height, random);
+
+    auto [low, high] = std::minmax_element(field.begin(), field.end());
+    const size_t num_buckets = std::clamp<size_t>(total_cells, 256, 65536);
+    const double scale = *high > *low ? (num_buckets - 1) / double(*high - *low) : 0.0;
+    std::vector<uint32_t> bucket(total_cells);
+    std::vector<size_t> start(num_buckets + 1, 0);
+    for (size_t pos = 0; pos < total_cells; pos++) {
+      // Highest value in bucket 0
+      bucket[pos] = static_cast<uint32_t>(num_buckets - 1 -
+                                          static_cast<size_t>((field[pos] - *low) * scale));
+      start[bucket[pos] + 1]++;
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+
+    emp::vector<size_t> order(total_cells);
+    for (size_t pos = 0; pos < total_cells; pos++) {
+      order[start[bucket[pos]]++] = pos;
+    }
+    if (mask)
+      mask->RemoveDestroyed(order); // Stable, so the ranking is kept
+    order.resize(TargetCount(order.size(), fraction));
+    return order;
+  }
+
+  /**
+   * @brief Build a fractal noise field of width x height
+   */
+  static std::vector<float> FractalField(int width, int height, emp::Random &random) {
+    std::vector<std::pair<int, int>> sizes = {{width, height}};
+    while (sizes.back().first > 2 || sizes.back().second > 2) {
+      sizes.push_back({(sizes.back().first + 1) / 2, (sizes.back().second + 1) / 2});
+    }
+
+    int level = static_cast<int>(sizes.size()) - 1;
+    std::vector<float> coarse(static_cast<size_t>(sizes[level].first) * sizes[level].second);
+    for (float &value : coarse) {
+      value = static_cast<float>(std::pow(2.0, level * CLUMPED_HURST) *
+                                 (random.GetDouble() - 0.5));
+    }
+
+    std::vector<float> fine;
+    for (level--; level >= 0; level--) {
+      const auto [coarse_w, coarse_h] = sizes[level + 1];
+      const auto [fine_w, fine_h] = sizes[level];
+      const float amplitude = static_cast<float>(std::pow(2.0, level * CLUMPED_HURST));
+      std::vector<int> x0(fine_w), x1(fine_w);
+      std::vector<float> fx(fine_w);
+      UpsampleAxis(fine_w, coarse_w, x0, x1, fx);
+
+      fine.assign(static_cast<size_t>(fine_w) * fine_h, 0.0f);
+      for (int y = 0; y < fine_h; y++) {
+        float cy = std::clamp((y - 0.5f) * 0.5f, 0.0f, float(coarse_h - 1));
+        int y0 = static_cast<int>(cy);
+        int y1 = std::min(y0 + 1, coarse_h - 1);
+        float fy = cy - y0;
+        const float *row0 = coarse.data() + static_cast<size_t>(y0) * coarse_w;
+        const float *row1 = coarse.data() + static_cast<size_t>(y1) * coarse_w;
+        float *out = fine.data() + static_cast<size_t>(y) * fine_w;
+        for (int x = 0; x < fine_w; x++) {
+          float top = row0[x0[x]] + fx[x] * (row0[x1[x]] - row0[x0[x]]);
+          float bottom = row1[x0[x]] + fx[x] * (row1[x1[x]] - row1[x0[x]]);
+          out[x] = top + fy * (bottom - top) +
+                   amplitude * static_cast<float>(random.GetDouble() - 0.5);
+        }
+      }
+      coarse.swap(fine);
+    }
+    return coarse;
+  }
+
+  /**
+   * @brief Source columns and weights of a 2x bilinear upsampling
+   */
+  static void UpsampleAxis(int fine_size, int coarse_size, std::vector<int> &i0,
+                           std::vector<int> &i1, std::vector<float> &weight) {
+    for (int i = 0; i < fine_size; i++) {
+      float c = std::clamp((i - 0.5f) * 0.5f, 0.0f, float(coarse_size - 1));
+      i0[i] = static_cast<int>(c);
+      i1[i] = std::min(i0[i] + 1, coarse_size - 1);
+      weight[i] = c - i0[i];
+    }
+  }
+
+  /**
+   * @brief Grow one invasion-percolation cluster
+   *
+   * Every cell gets a random threshold; starting from a random cell, the
+   * cluster repeatedly invades the lowest-threshold cell on its boundary
+   * (von Neumann neighbours, no wrapping).  The result is a single connected,
+   * branching patch of destroyed habitat with exactly TargetCount cells, in
+   * invasion order.  The frontier is a bucket queue over the thresholds, so
+   * each step is O(1).  Non-habitat cells of a mask are invaded like any
+   * other but not listed, so the cluster is connected through them and still
+   * reaches every habitat cell.
+   */
+  static emp::vector<size_t> PercolationOrder(double fraction, int width, int height,
+                                              emp::Random &random, const HabitatMask *mask) {
+    const size_t total_cells = static_cast<size_t>(width) * height;
+    size_t num_habitat = total_cells;
+    if (mask) {
+      for (size_t pos = 0; pos < total_cells; pos++) {
+        num_habitat -= mask->IsDestroyed(pos);
+      }
+    }
+    const size_t target = TargetCount(num_habitat, fraction);
+    emp::vector<size_t> order;
+    if (target == 0)
+      return order;
+    order.reserve(target);
+
+    std::vector<uint8_t> threshold(total_cells);
+    for (uint8_t &value : threshold) {
+      value = static_cast<uint8_t>(random.GetUInt(PERCOLATION_LEVELS));
+    }
+    std::vector<uint8_t> reached(total_cells, 0);
+    std::vector<std::vector<size_t>> frontier(PERCOLATION_LEVELS);
+    size_t lowest = PERCOLATION_LEVELS;
+    auto reach = [&](size_t pos) {
+      if (!reached[pos]) {
+        reached[pos] = 1;
+        frontier[threshold[pos]].push_back(pos);
+        lowest = std::min<size_t>(lowest, threshold[pos]);
+      }
+    };
+
+    reach(random.GetUInt(total_cells));
+    while (order.size() < target) {
+      while (frontier[lowest].empty())
+        lowest++;
+      size_t pos = frontier[lowest].back();
+      frontier[lowest].pop_back();
+      if (!(mask && mask->IsDestroyed(pos)))
+        order.push_back(pos);
+
+      size_t row = pos / width, col = pos % width;
+      if (col > 0) reach(pos - 1);
+      if (col + 1 < static_cast<size_t>(width)) reach(pos + 1);
+      if (row > 0) reach(pos - width);
+      if (row + 1 < static_cast<size_t>(height)) reach(pos + width);
+    }
+    return order;
+  }
+
+  /**
+   * @brief Fisher-Yates shuffle
+   */
+  static void Shuffle(emp::vector<size_t> &order, emp::Random &random) {
+    for (size_t i = order.size(); i-- > 1;) {
+      std::swap(order[i], order[random.GetUInt(i + 1)]);
+    }
+  }
+};
+
+/**
+ * @brief Thread-safe cache of landscapes keyed by (pattern, fraction, seed, mask)
+ *
+ * Sweeps that vary only the number of rounds, or rerun a landscape with
+ * another ecology seed, share one generated landscape.  A landscape drawn
+ * from its own seed depends only on the key, so a cache hit returns exactly
+ * what generating it again would.  Least recently used entries are dropped
+ * beyond the capacity; each holds up to one size_t per cell.
+ */
+class LandscapeCache {
+public:
+  using Landscape = std::shared_ptr<const emp::vector<size_t>>;
+
+private:
+  struct Entry {
+    int pattern;
+    double fraction;
+    int width;
+    int height;
+    int seed;
+    const HabitatMask *mask;
+    Landscape order;
+  };
+
+  std::mutex mutex;
+  std::vector<Entry> entries; ///< Least recently used first
+  size_t capacity;
+  size_t hits = 0;
+  size_t misses = 0;
+
+public:
+  /**
+   * @param capacity Maximum number of landscapes kept
+   */
+  explicit LandscapeCache(size_t capacity = 64) : capacity(std::max<size_t>(1, capacity)) {}
+
+  /**
+   * @brief Get a landscape, generating it on a miss
+   * @param seed Seed of the generator the landscape is drawn from
+   * @param mask Non-habitat cells (nullptr = none); must outlive the cache
+   * @return Cells in destruction order
+   *
+   * Generation runs outside the lock, so threads asking for different
+   * landscapes do not wait on each other.
+   */
+  Landscape Get(int pattern, double fraction, int width, int height, int seed,
+                const HabitatMask *mask = nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &entry = entries[i];
+        if (entry.pattern == pattern && entry.fraction == fraction &&
+            entry.width == width && entry.height == height && entry.seed == seed &&
+            entry.mask == mask) {
+          Entry found = entry;
+          entries.erase(entries.begin() + i);
+          entries.push_back(found);
+          hits++;
+          return found.order;
+        }
+      }
+      misses++;
+    }
+
+    emp::Random random(seed);
+    Landscape order = std::make_shared<const emp::vector<size_t>>(
+        LandscapeGenerator::Generate(pattern, fraction, width, height, random, mask));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back({pattern, fraction, width, height, seed, mask, order});
+    if (entries.size() > capacity)
+      entries.erase(entries.begin());
+    return order;
+  }
+
+  /**
+   * @brief Get the number of requests answered from the cache
+   */
+  size_t GetHits() const { return hits; }
+
+  /**
+   * @brief Get the number of landscapes generated
+   */
+  size_t GetMisses() const { return misses; }
+};
+
+#endif
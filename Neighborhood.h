@@ -0,0 +1,163 @@
+#ifndef NEIGHBORHOOD_H
+#define NEIGHBORHOOD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Shape of the neighbourhood a colonizer can reach
+ */
+enum class NeighborhoodType {
+  MOORE = 0,      ///< All 8 surrounding cells
+  VON_NEUMANN = 1 ///< The 4 orthogonally adjacent cells
+};
+
+/**
+ * @brief Fixed-size, allocation-free view of one cell's neighbours
+ *
+ * Neighbours are center + offsets[i]; the offsets are shared by every cell
+ * with the same border class, so a view is just a pointer and a count.
+ */
+class NeighborView {
+private:
+  size_t center;
+  const std::ptrdiff_t *offsets;
+  size_t count;
+
+public:
+  class iterator {
+  private:
+    size_t center;
+    const std::ptrdiff_t *offset;
+
+  public:
+    iterator(size_t _center, const std::ptrdiff_t *_offset)
+        : center(_center), offset(_offset) {}
+    size_t operator*() const { return center + *offset; }
+    iterator &operator++() {
+      ++offset;
+      return *this;
+    }
+    bool operator!=(const iterator &other) const { return offset != other.offset; }
+  };
+
+  NeighborView(size_t _center, const std::ptrdiff_t *_offsets, size_t _count)
+      : center(_center), offsets(_offsets), count(_count) {}
+
+  size_t size() const { return count; }
+  size_t operator[](size_t i) const { return center + offsets[i]; }
+  iterator begin() const { return iterator(center, offsets); }
+  iterator end() const { return iterator(center, offsets + count); }
+};
+
+/**
+ * @brief Precomputed neighbourhood table for a rectangular grid
+ *
+ * Every cell is assigned one of 16 border classes (touching the left,
+ * right, top and/or bottom edge).  Each class stores the signed index
+ * offsets of its neighbours, so looking up a neighbourhood costs one byte
+ * load and no division, modulo or bounds checks.  Neighbours are listed in
+ * the original dx-major order (dx = -1..1, then dy = -1..1), so the random
+ * target choice matches the old GetNeighborPositions exactly.
+ */
+class Neighborhood {
+public:
+  static constexpr size_t MAX_NEIGHBORS = 8;
+
+private:
+  /// Border class flags
+  static constexpr uint8_t LEFT = 1, RIGHT = 2, TOP = 4, BOTTOM = 8;
+
+  std::vector<uint8_t> cell_class; ///< Border class of each cell
+  std::array<std::array<std::ptrdiff_t, MAX_NEIGHBORS>, 16> class_offsets{};
+  std::array<uint8_t, 16> class_counts{};
+  NeighborhoodType type = NeighborhoodType::MOORE;
+  bool wrap = false;
+
+public:
+  /**
+   * @brief Build the table for a grid
+   * @param width Grid width
+   * @param height Grid height
+   * @param _type Moore or von Neumann neighbourhood
+   * @param _wrap True to wrap edges (torus), false for hard boundaries
+   */
+  void Build(int width, int height, NeighborhoodType _type = NeighborhoodType::MOORE,
+             bool _wrap = false) {
+    type = _type;
+    wrap = _wrap;
+
+    for (uint8_t flags = 0; flags < 16; flags++) {
+      BuildClass(flags, width, height);
+    }
+
+    cell_class.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+      uint8_t row_flags = (y == 0 ? TOP : 0) | (y == height - 1 ? BOTTOM : 0);
+      for (int x = 0; x < width; x++) {
+        cell_class[static_cast<size_t>(y) * width + x] =
+            row_flags | (x == 0 ? LEFT : 0) | (x == width - 1 ? RIGHT : 0);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the neighbours of a cell
+   * @param pos Cell index
+   * @return View over the neighbouring cell indices
+   */
+  NeighborView GetNeighbors(size_t pos) const {
+    uint8_t flags = cell_class[pos];
+    return NeighborView(pos, class_offsets[flags].data(), class_counts[flags]);
+  }
+
+  NeighborhoodType GetType() const { return type; }
+  bool GetWrap() const { return wrap; }
+
+private:
+  /**
+   * @brief Compute the neighbour offsets for one border class
+   */
+  void BuildClass(uint8_t flags, int width, int height) {
+    std::array<std::ptrdiff_t, MAX_NEIGHBORS> &offsets = class_offsets[flags];
+    uint8_t count = 0;
+
+    for (int dx = -1; dx <= 1; dx++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        if (dx == 0 && dy == 0)
+          continue; // Skip center position
+        if (type == NeighborhoodType::VON_NEUMANN && dx != 0 && dy != 0)
+          continue;
+
+        std::ptrdiff_t ox = dx;
+        std::ptrdiff_t oy = dy;
+        if ((dx < 0 && (flags & LEFT)) || (dx > 0 && (flags & RIGHT))) {
+          if (!wrap)
+            continue;
+          ox = dx < 0 ? width - 1 : -(width - 1);
+        }
+        if ((dy < 0 && (flags & TOP)) || (dy > 0 && (flags & BOTTOM))) {
+          if (!wrap)
+            continue;
+          oy = dy < 0 ? height - 1 : -(height - 1);
+        }
+
+        // On grids narrower than 3 cells wrapping can reach the same cell
+        // twice or the cell itself; keep each neighbour once
+        std::ptrdiff_t offset = oy * width + ox;
+        bool duplicate = (offset == 0);
+        for (uint8_t i = 0; i < count && !duplicate; i++) {
+          duplicate = (offsets[i] == offset);
+        }
+        if (!duplicate) {
+          offsets[count++] = offset;
+        }
+      }
+    }
+    class_counts[flags] = count;
+  }
+};
+
+#endif
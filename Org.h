@@ -4,6 +4,8 @@
 #include "emp/math/Random.hpp"
 #include "emp/tools/string_utils.hpp"
 
+#include "OrganismPool.h"
+
 // Forward declaration
 class OrgWorld;
 
@@ -36,6 +38,22 @@ class Organism {
 
         virtual ~Organism() = default;
 
+        /**
+         * @brief Allocate organisms from OrganismPool
+         *
+         * Inherited by every species, so `new`, CreateOffspring and the
+         * world's deletes recycle memory instead of going to the heap.
+         */
+        static void *operator new(size_t size) { return OrganismPool::Allocate(size); }
+
+        /**
+         * @brief Return an organism's memory to OrganismPool
+         * @param size Size of the dynamic type (the destructor is virtual)
+         */
+        static void operator delete(void *ptr, size_t size) {
+            OrganismPool::Deallocate(ptr, size);
+        }
+
         /**
          * @brief Get species identifier
          * @return Species ID (0=c, 1=d)
@@ -58,12 +76,16 @@ class Organism {
          * @brief Process organism behavior within the world context
          * @param world Reference to the world
          * @param pos Current position in the world
+         *
+         * The world owns its organisms: world.RemoveOrganism(pos) deletes
+         * this organism, so return right after calling it.
          */
         virtual void ProcessInWorld(OrgWorld& world, size_t pos) = 0;
 
         /**
          * @brief Create offspring of this organism
-         * @return Pointer to new organism offspring
+         * @return Pointer to new organism offspring, owned by the world once
+         *         placed with AddOrgAt
          */
         virtual emp::Ptr<Organism> CreateOffspring() = 0;
         
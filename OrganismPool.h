@@ -0,0 +1,208 @@
+#ifndef ORGANISM_POOL_H
+#define ORGANISM_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+/**
+ * @brief Free-list allocator for organism objects
+ *
+ * Blocks are grouped into size classes of ALIGN bytes, so every organism
+ * type of one size (SpeciesC and SpeciesD, or a user-defined species) shares
+ * a free list.  Freed blocks go to the calling thread's cache and are reused
+ * by its next allocation of that size, so a run that keeps its population
+ * size allocates no new memory once the population has peaked.
+ *
+ * Each thread takes blocks from a shared store in batches, under a mutex.
+ * A thread that frees more than MAX_CACHED blocks of one size hands a batch
+ * back, and every thread returns its cache to the store when it exits, so
+ * organisms may be freed on a different thread from the one that made
+ * them without one thread's cache growing without bound.  Chunks are
+ * never returned to the system: objects may outlive any thread, and memory
+ * stays at the peak number of live organisms.  Objects larger than
+ * MAX_SIZE use the global operator new.
+ */
+class OrganismPool {
+public:
+  static constexpr size_t ALIGN = alignof(std::max_align_t);
+  static constexpr size_t MAX_SIZE = 256;                 ///< Largest pooled object
+  static constexpr size_t NUM_CLASSES = MAX_SIZE / ALIGN;
+  static constexpr size_t CHUNK_BYTES = 64 * 1024;        ///< Bytes carved at a time
+  static constexpr size_t BATCH = 64;                     ///< Blocks moved per refill
+  static constexpr size_t MAX_CACHED = 4 * BATCH;         ///< Blocks a thread keeps per size
+
+  /**
+   * @brief Allocate a block of at least size bytes
+   */
+  static void *Allocate(size_t size) {
+    if (size > MAX_SIZE)
+      return ::operator new(size);
+    ThreadCache &cache = GetCache();
+    if (cache.returned)
+      return TakeShared(SizeClass(size));
+    FreeList &list = cache.lists[SizeClass(size)];
+    if (!list.head)
+      Refill(SizeClass(size), list);
+    return Pop(list);
+  }
+
+  /**
+   * @brief Return a block from Allocate
+   * @param size The size passed to Allocate
+   */
+  static void Deallocate(void *ptr, size_t size) {
+    if (!ptr)
+      return;
+    if (size > MAX_SIZE) {
+      ::operator delete(ptr);
+      return;
+    }
+    ThreadCache &cache = GetCache();
+    if (cache.returned) {
+      SharedStore &store = GetStore();
+      std::lock_guard<std::mutex> lock(store.mutex);
+      Push(store.lists[SizeClass(size)], static_cast<Block *>(ptr));
+      return;
+    }
+    FreeList &list = cache.lists[SizeClass(size)];
+    Push(list, static_cast<Block *>(ptr));
+    if (list.count > MAX_CACHED)
+      Release(SizeClass(size), list, BATCH);
+  }
+
+private:
+  struct Block {
+    Block *next;
+  };
+
+  struct FreeList {
+    Block *head = nullptr;
+    size_t count = 0;
+  };
+
+  /**
+   * @brief Blocks not held by any thread, and the lock that guards them
+   */
+  struct SharedStore {
+    std::mutex mutex;
+    std::array<FreeList, NUM_CLASSES> lists;
+  };
+
+  /**
+   * @brief Per-thread free lists
+   *
+   * Trivially destructible, so blocks freed while other thread-local
+   * objects are being destroyed still land in valid storage.  Once the
+   * lists have been returned, the thread allocates and frees through the
+   * store directly.
+   */
+  struct ThreadCache {
+    std::array<FreeList, NUM_CLASSES> lists;
+    bool returned = false;
+  };
+
+  /**
+   * @brief Hands a thread's free lists back to the store when it exits
+   */
+  struct CacheReturn {
+    ThreadCache *cache;
+
+    explicit CacheReturn(ThreadCache *cache) : cache(cache) {}
+
+    ~CacheReturn() {
+      for (size_t size_class = 0; size_class < NUM_CLASSES; size_class++) {
+        FreeList &list = cache->lists[size_class];
+        Release(size_class, list, list.count);
+      }
+      cache->returned = true;
+    }
+  };
+
+  static size_t SizeClass(size_t size) { return size == 0 ? 0 : (size - 1) / ALIGN; }
+
+  static void Push(FreeList &list, Block *block) {
+    block->next = list.head;
+    list.head = block;
+    list.count++;
+  }
+
+  static Block *Pop(FreeList &list) {
+    Block *block = list.head;
+    list.head = block->next;
+    list.count--;
+    return block;
+  }
+
+  /**
+   * @brief The store outlives every thread cache and every organism
+   */
+  static SharedStore &GetStore() {
+    static SharedStore *store = new SharedStore();
+    return *store;
+  }
+
+  /**
+   * @brief Get the calling thread's cache; the first call on a thread
+   *        registers its return at thread exit
+   */
+  static ThreadCache &GetCache() {
+    thread_local ThreadCache cache;
+    thread_local CacheReturn cache_return(&cache);
+    (void)cache_return;
+    return cache;
+  }
+
+  /**
+   * @brief Carve a chunk into blocks of a size class if the store has none
+   * @note Call with the store's mutex held
+   */
+  static void CarveIfEmpty(size_t size_class, FreeList &shared) {
+    if (shared.head)
+      return;
+    const size_t block_size = (size_class + 1) * ALIGN;
+    char *chunk = static_cast<char *>(::operator new(CHUNK_BYTES));
+    for (size_t offset = 0; offset + block_size <= CHUNK_BYTES; offset += block_size) {
+      Push(shared, reinterpret_cast<Block *>(chunk + offset));
+    }
+  }
+
+  /**
+   * @brief Take one block straight from the store, after the thread's cache
+   *        has been returned
+   */
+  static void *TakeShared(size_t size_class) {
+    SharedStore &store = GetStore();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    CarveIfEmpty(size_class, store.lists[size_class]);
+    return Pop(store.lists[size_class]);
+  }
+
+  /**
+   * @brief Move up to num_blocks blocks from a thread list to the store
+   */
+  static void Release(size_t size_class, FreeList &list, size_t num_blocks) {
+    SharedStore &store = GetStore();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    for (size_t moved = 0; moved < num_blocks && list.head; moved++) {
+      Push(store.lists[size_class], Pop(list));
+    }
+  }
+
+  /**
+   * @brief Move a batch of blocks into an empty thread list, carving a new
+   *        chunk if the store has none of this size
+   */
+  static void Refill(size_t size_class, FreeList &list) {
+    SharedStore &store = GetStore();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    FreeList &shared = store.lists[size_class];
+    CarveIfEmpty(size_class, shared);
+    for (size_t moved = 0; moved < BATCH && shared.head; moved++) {
+      Push(list, Pop(shared));
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef POPULATE_H
+#define POPULATE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "emp/math/Random.hpp"
+
+#include "CommunityWorld.h"
+#include "CompactWorld.h"
+#include "GillespieWorld.h"
+#include "SpeciesC.h"
+#include "SpeciesD.h"
+#include "World.h"
+
+/**
+  * @brief Add both species to occupy initial_occupancy / 2 each of available habitat
+  * 
+  * Based on the paper's specification that "each species occupies 0.25 
+  * of the remaining available habitat" at initialization, which is the
+  * default initial_occupancy of 0.5.
+  */
+  inline void PopulateWithBothSpecies(OrgWorld &world, double initial_occupancy,
+     emp::Random &random_generator) {
+      // Clear existing organisms
+      world.RemoveAllOrganisms();
+      // Count available cells (non-destroyed habitat)
+      std::vector<size_t> available_cells = world.GetAvailableCells();
+    // Calculate how many cells each species should occupy
+    // Each species gets half of the initial occupancy
+    int cells_per_species =
+        static_cast<int>(available_cells.size() * initial_occupancy / 2);
+     // Manually shuffle the available cells for random distribution
+     for (size_t i = available_cells.size(); i-- > 1;) {
+          size_t j = random_generator.GetUInt(i + 1);
+          std::swap(available_cells[i], available_cells[j]);
+    }
+   // Add species C to the first block of shuffled available cells
+     for (int i = 0; i < cells_per_species && i < static_cast<int>(available_cells.size()); i++) {
+            SpeciesC* new_organism = new SpeciesC(&random_generator);
+            world.AddOrgAt(new_organism, available_cells[i]);
+      }
+            
+   // Add species D to the next block of shuffled available cells
+       for (int i = cells_per_species; 
+        i < cells_per_species * 2 && i < static_cast<int>(available_cells.size()); i++) {
+        SpeciesD* new_organism = new SpeciesD(&random_generator);
+        world.AddOrgAt(new_organism, available_cells[i]);
+    }
+  }
+/**
+ * @brief Helper function that adds species D to random available positions
+ */
+inline void PopulateWithSpeciesD(OrgWorld &world, double initial_occupancy,
+                          emp::Random &random_generator) {
+  // Clear existing organisms
+  world.RemoveAllOrganisms();
+  // Count available cells
+  std::vector<size_t> available_cells = world.GetAvailableCells();
+  // Populate initial_occupancy fraction of available cells
+  int target_organisms =
+      static_cast<int>(available_cells.size() * initial_occupancy);
+
+  // Manually shuffle the available cells
+  for (size_t i = available_cells.size(); i-- > 1;) {
+    size_t j = random_generator.GetUInt(i + 1);
+    std::swap(available_cells[i], available_cells[j]);
+  }
+
+  for (int i = 0; i < target_organisms && i < static_cast<int>(available_cells.size()); i++) {
+    emp::Ptr<SpeciesD> new_organism = new SpeciesD(&random_generator);
+    world.AddOrgAt(new_organism, available_cells[i]);
+  }
+}
+
+
+/**
+ * @brief Compact-engine overload so RunExperiment can populate either world
+ */
+inline void PopulateWithBothSpecies(CompactWorld &world, double initial_occupancy,
+                             emp::Random &random_generator) {
+  world.PopulateWithBothSpecies(initial_occupancy);
+}
+
+/**
+ * @brief Community overload so RunExperiment can populate it; every species
+ *        gets an equal share of initial_occupancy
+ */
+inline void PopulateWithBothSpecies(CommunityWorld &world, double initial_occupancy,
+                             emp::Random &random_generator) {
+  world.PopulateCommunity(initial_occupancy);
+}
+
+/**
+ * @brief Event-driven-engine overload so RunExperiment can populate it
+ */
+inline void PopulateWithBothSpecies(GillespieWorld &world, double initial_occupancy,
+                             emp::Random &random_generator) {
+  world.PopulateWithBothSpecies(initial_occupancy);
+}
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef RANDOM_BUFFER_H
+#define RANDOM_BUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Bitplane.h"
+#include "CounterRNG.h"
+
+/**
+ * @brief One update's keyed Bernoulli draws for every cell, made in bulk
+ *
+ * For each (purpose, probability) pair in use, holds a Bitplane whose bit
+ * for cell c is CounterRNG::P(p, update, c, purpose).  Fill makes the draws
+ * a 64-cell block at a time: the slice words of each purpose are made once,
+ * at the depth of its most precise probability, and every mask of that
+ * purpose is one CounterRNG::SliceCompare over them.  The per-event work
+ * becomes a bit test.  The bits are exactly the keyed draws, so buffered
+ * and unbuffered runs are identical.
+ *
+ * Pairs are registered up front (CompactWorld registers its species
+ * table) or learned: a caller whose Lookup misses can Register the pair,
+ * answer with a scalar draw, and have it buffered from the next fill on.
+ * Blocks of 64 cells the caller marks inactive (no organism) are skipped
+ * and must not be queried.  Lookup is const, so filled buffers can be read
+ * from many threads; FillWords ranges can be filled concurrently.
+ */
+class DrawBuffer {
+public:
+  /// Most (purpose, probability) pairs buffered; further pairs stay scalar
+  static constexpr size_t MAX_MASKS = 8;
+
+private:
+  struct Mask {
+    RngPurpose purpose;
+    double p;
+    uint64_t threshold; ///< CounterRNG::Threshold(p)
+    Bitplane bits;
+  };
+  std::vector<Mask> masks;
+  uint64_t filled_update = 0;
+  bool filled = false; ///< Masks hold the draws of filled_update
+
+public:
+  /**
+   * @brief Draw every buffered pair for one update
+   * @param rng Keyed generator
+   * @param update Update to draw for
+   * @param num_cells Grid size
+   * @param active active(w) is false if cells [64w, 64w + 64) need no draws
+   */
+  template <typename ACTIVE>
+  void Fill(const CounterRNG &rng, uint64_t update, size_t num_cells, ACTIVE active) {
+    Prepare(num_cells);
+    FillWords(rng, update, 0, (num_cells + 63) / 64, active);
+    MarkFilled(update);
+  }
+
+  /**
+   * @brief Size the masks for a grid; first step of a split fill
+   */
+  void Prepare(size_t num_cells) {
+    filled = false;
+    for (Mask &mask : masks) {
+      mask.bits.Resize(num_cells);
+    }
+  }
+
+  /**
+   * @brief Fill mask words [first_word, last_word); see Fill
+   */
+  template <typename ACTIVE>
+  void FillWords(const CounterRNG &rng, uint64_t update, size_t first_word,
+                 size_t last_word, ACTIVE active) {
+    std::array<uint64_t, CounterRNG::BERNOULLI_BITS> words;
+    for (size_t w = first_word; w < last_word; w++) {
+      if (!active(w))
+        continue;
+      // Masks are grouped by purpose; make each purpose's words once
+      for (size_t group = 0; group < masks.size();) {
+        size_t end = group;
+        int depth = 0;
+        while (end < masks.size() && masks[end].purpose == masks[group].purpose) {
+          depth = std::max(depth, CounterRNG::SliceDepth(masks[end].threshold));
+          end++;
+        }
+        rng.FillSliceWords(update, w, masks[group].purpose, depth, words.data());
+        for (size_t m = group; m < end; m++) {
+          masks[m].bits.GetWords()[w] =
+              CounterRNG::SliceCompare(words.data(), masks[m].threshold);
+        }
+        group = end;
+      }
+    }
+  }
+
+  /**
+   * @brief Declare the masks complete for an update; last step of a split fill
+   */
+  void MarkFilled(uint64_t update) {
+    filled_update = update;
+    filled = true;
+  }
+
+  /**
+   * @brief Look up a buffered draw
+   * @param update Update of the draw
+   * @param cell Cell of the draw
+   * @param purpose What the draw is for
+   * @param p Probability
+   * @param value Set to the draw if it is buffered
+   * @return True if the draw was buffered
+   */
+  bool Lookup(uint64_t update, uint64_t cell, RngPurpose purpose, double p,
+              bool &value) const {
+    if (!filled || filled_update != update)
+      return false;
+    for (const Mask &mask : masks) {
+      if (mask.purpose == purpose && mask.p == p) {
+        value = mask.bits.Get(cell);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Buffer a (purpose, probability) pair from the next fill on
+   *
+   * Does nothing if the pair is known or MAX_MASKS pairs are buffered.
+   */
+  void Register(RngPurpose purpose, double p) {
+    if (masks.size() >= MAX_MASKS)
+      return;
+    for (const Mask &mask : masks) {
+      if (mask.purpose == purpose && mask.p == p)
+        return;
+    }
+    filled = false;
+    size_t at = masks.size();
+    for (size_t m = 0; m < masks.size(); m++) {
+      if (masks[m].purpose == purpose)
+        at = m + 1;
+    }
+    masks.insert(masks.begin() + at, Mask{purpose, p, CounterRNG::Threshold(p), Bitplane()});
+  }
+
+};
+
+/**
+ * @brief Draw interface over a CounterRNG and an optional DrawBuffer
+ *
+ * Same draws as KeyedDraws; Bernoulli draws come from the buffer when it
+ * holds them.
+ */
+struct BufferedDraws {
+  const CounterRNG &rng;
+  uint64_t update;
+  const DrawBuffer &buffer;
+
+  bool P(double p, uint64_t cell, RngPurpose purpose) {
+    bool value;
+    if (buffer.Lookup(update, cell, purpose, p, value))
+      return value;
+    return rng.P(p, update, cell, purpose);
+  }
+  size_t GetUInt(size_t max, uint64_t cell, RngPurpose purpose) {
+    return rng.GetUInt(static_cast<uint32_t>(max), update, cell, purpose);
+  }
+};
+
+/**
+ * @brief Fisher-Yates shuffle whose swap indices are keyed draws made in bulk
+ * @param positions Values to shuffle in place
+ * @param rng Keyed generator
+ * @param update Update of the draws
+ * @param key_base Step i uses cell key key_base + i
+ *
+ * Identical to drawing GetUInt(i + 1, update, key_base + i, ORDER) for each
+ * step, but the bits are generated 64 steps at a time.
+ */
+template <typename VEC>
+void KeyedShuffle(VEC &positions, const CounterRNG &rng, uint64_t update,
+                  uint64_t key_base) {
+  std::array<uint64_t, 64> bits;
+  size_t i = positions.size();
+  while (i > 1) {
+    // Steps i-1 down to max(1, i-64)
+    size_t low = i > 65 ? i - 64 : 1;
+    rng.FillBits(update, key_base + low, i - low, RngPurpose::ORDER, bits.data());
+    for (size_t step = i; step-- > low;) {
+      size_t j = CounterRNG::BitsToUInt(bits[step - low], static_cast<uint32_t>(step + 1));
+      std::swap(positions[step], positions[j]);
+    }
+    i = low;
+  }
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef REPLICATE_STATS_H
+#define REPLICATE_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Streaming mean and variance (Welford's algorithm)
+ *
+ * Numerically stable in one pass with O(1) memory.
+ */
+class RunningStats {
+private:
+  uint64_t count = 0;
+  double mean = 0.0;
+  double m2 = 0.0; ///< Sum of squared deviations from the mean
+
+public:
+  void Add(double value) {
+    count++;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+  }
+
+  uint64_t GetCount() const { return count; }
+  double GetMean() const { return mean; }
+
+  /**
+   * @brief Get the sample variance (0 with fewer than two values)
+   */
+  double GetVariance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+  double GetStdDev() const { return std::sqrt(GetVariance()); }
+};
+
+/**
+ * @brief Streaming quantile sketch: a histogram of at most MAX_BINS bins
+ *        (Ben-Haim and Tom-Tov, 2010)
+ *
+ * Each bin is a value and the number of values merged into it.  While the
+ * data have at most MAX_BINS distinct values, as final counts of a few
+ * hundred replicates usually do, every bin is exact and so are the
+ * quantiles; beyond that the two closest bins are merged into their
+ * weighted mean.  Memory is O(MAX_BINS) regardless of the number of values.
+ */
+class QuantileSketch {
+public:
+  static constexpr size_t MAX_BINS = 256;
+
+private:
+  std::vector<std::pair<double, uint64_t>> bins; ///< (value, count), by value
+  uint64_t count = 0;
+
+public:
+  void Add(double value) {
+    count++;
+    auto bin = std::lower_bound(bins.begin(), bins.end(), value,
+                                [](const std::pair<double, uint64_t> &b, double v) {
+                                  return b.first < v;
+                                });
+    if (bin != bins.end() && bin->first == value) {
+      bin->second++;
+      return;
+    }
+    bins.insert(bin, {value, 1});
+    if (bins.size() > MAX_BINS) {
+      size_t closest = 0;
+      for (size_t i = 1; i + 1 < bins.size(); i++) {
+        if (bins[i + 1].first - bins[i].first <
+            bins[closest + 1].first - bins[closest].first)
+          closest = i;
+      }
+      auto &[left_value, left_count] = bins[closest];
+      const auto &[right_value, right_count] = bins[closest + 1];
+      left_value = (left_value * left_count + right_value * right_count) /
+                   (left_count + right_count);
+      left_count += right_count;
+      bins.erase(bins.begin() + closest + 1);
+    }
+  }
+
+  uint64_t GetCount() const { return count; }
+
+  /**
+   * @brief Estimate a quantile
+   * @param p Quantile in [0, 1]
+   * @return Linear interpolation between the order statistics around
+   *         p * (count - 1), as R's default quantile type; 0 if empty
+   */
+  double Get(double p) const {
+    if (count == 0)
+      return 0.0;
+    double rank = std::clamp(p, 0.0, 1.0) * (count - 1);
+    uint64_t below = static_cast<uint64_t>(rank);
+    double low = OrderStatistic(below);
+    double high = OrderStatistic(std::min(below + 1, count - 1));
+    return low + (rank - below) * (high - low);
+  }
+
+private:
+  /**
+   * @brief Value of the i-th smallest value (0-based)
+   */
+  double OrderStatistic(uint64_t i) const {
+    uint64_t seen = 0;
+    for (const auto &[value, bin_count] : bins) {
+      seen += bin_count;
+      if (i < seen)
+        return value;
+    }
+    return bins.back().first;
+  }
+};
+
+/**
+ * @brief Replicate summary of one species' final count
+ */
+class CountSummary {
+public:
+  /// Quantiles written to the summary table
+  static constexpr std::array<double, 5> QUANTILES = {0.05, 0.25, 0.5, 0.75, 0.95};
+  /// Column suffixes of QUANTILES
+  static constexpr std::array<const char *, 5> QUANTILE_NAMES = {"Q05", "Q25", "Median",
+                                                                 "Q75", "Q95"};
+
+private:
+  RunningStats stats;
+  QuantileSketch quantiles;
+  uint64_t extinct = 0; ///< Replicates that ended with no cells
+
+public:
+  void Add(int count) {
+    stats.Add(count);
+    quantiles.Add(count);
+    if (count == 0)
+      extinct++;
+  }
+
+  const RunningStats &GetStats() const { return stats; }
+  const QuantileSketch &GetQuantiles() const { return quantiles; }
+  uint64_t GetExtinct() const { return extinct; }
+};
+
+/**
+ * @brief Online aggregation of the replicates of one parameter point
+ *
+ * Holds one CountSummary per species plus the number of replicates in
+ * which every species persisted, so its memory does not grow with the
+ * number of replicates.  Sweep results arrive in job order with the
+ * replicates of a point adjacent, so one ReplicateSummary is reused
+ * point after point.
+ */
+class ReplicateSummary {
+private:
+  std::vector<std::string> species_names;
+  std::vector<CountSummary> species;
+  uint64_t replicates = 0;
+  uint64_t coexisting = 0; ///< Replicates in which no species went extinct
+
+public:
+  /**
+   * @param names Column name of each species, e.g. Species_C
+   */
+  explicit ReplicateSummary(std::vector<std::string> names)
+      : species_names(std::move(names)), species(species_names.size()) {}
+
+  /**
+   * @brief Forget every replicate, ready for the next point
+   */
+  void Reset() {
+    species.assign(species_names.size(), CountSummary());
+    replicates = 0;
+    coexisting = 0;
+  }
+
+  /**
+   * @brief Add one replicate's final counts
+   * @param counts One count per species first; further entries are ignored
+   */
+  void Add(const std::vector<int> &counts) {
+    bool all_persist = true;
+    for (size_t i = 0; i < species.size(); i++) {
+      species[i].Add(counts[i]);
+      all_persist = all_persist && counts[i] > 0;
+    }
+    replicates++;
+    if (all_persist)
+      coexisting++;
+  }
+
+  uint64_t GetReplicates() const { return replicates; }
+  uint64_t GetCoexisting() const { return coexisting; }
+  const CountSummary &GetSpecies(size_t i) const { return species[i]; }
+
+  /**
+   * @brief Write the summary columns' header, without a line break
+   *
+   * Per species: _Mean, _SD, the quantiles and _Extinct (the number of
+   * replicates ending at 0, so _Extinct / Replicates is the extinction
+   * probability); then Replicates and Coexisting.
+   */
+  void WriteHeader(std::ostream &out) const {
+    for (const std::string &name : species_names) {
+      out << name << "_Mean," << name << "_SD,";
+      for (const char *quantile : CountSummary::QUANTILE_NAMES) {
+        out << name << "_" << quantile << ",";
+      }
+      out << name << "_Extinct,";
+    }
+    out << "Replicates,Coexisting";
+  }
+
+  /**
+   * @brief Write the summary columns of the current point, without a line break
+   */
+  void WriteRow(std::ostream &out) const {
+    for (const CountSummary &summary : species) {
+      out << summary.GetStats().GetMean() << "," << summary.GetStats().GetStdDev() << ",";
+      for (double quantile : CountSummary::QUANTILES) {
+        out << summary.GetQuantiles().Get(quantile) << ",";
+      }
+      out << summary.GetExtinct() << ",";
+    }
+    out << replicates << "," << coexisting;
+  }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define SPECIES_C_H
 
 #include "Org.h"
+#include "SpeciesTraits.h"
 #include "World.h"
 
 /**
@@ -13,8 +14,9 @@
  */
 class SpeciesC : public Organism {
     private:
-        static constexpr double COLONIZATION_RATE = 0.2;  ///< Colonization rate for species c
-        static constexpr double EXTINCTION_RATE = 0.1;    ///< Local extinction rate
+        using Traits = SuperiorCompetitor;  ///< Rates shared with CompactWorld
+        static constexpr double COLONIZATION_RATE = Traits::COLONIZATION_RATE;  ///< Colonization rate for species c
+        static constexpr double EXTINCTION_RATE = Traits::EXTINCTION_RATE;      ///< Local extinction rate
 
     public:
         /**
@@ -31,7 +33,7 @@ class SpeciesC : public Organism {
          */
         void ProcessInWorld(OrgWorld& world, size_t pos) override {
             // Check for extinction
-            if (random->P(extinction_rate)) {
+            if (world.DrawP(pos, RngPurpose::EXTINCTION, extinction_rate)) {
                 world.RemoveOrganism(pos);
                 return;
             }
@@ -0,0 +1,133 @@
+#ifndef SPECIES_TRAITS_H
+#define SPECIES_TRAITS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Per-species parameters
+ */
+struct SpeciesParams {
+  double colonization_rate; ///< Probability of a colonization attempt per update
+  double extinction_rate;   ///< Probability of local extinction per update
+};
+
+/**
+ * @brief Species C - superior competitor with inferior dispersal ability
+ *
+ * A species traits type holds the species' rates and its competitive rank
+ * as compile-time constants.  Lower ranks displace higher ranks; species of
+ * equal rank cannot displace each other.
+ */
+struct SuperiorCompetitor {
+  static constexpr double COLONIZATION_RATE = 0.2; ///< Colonization rate
+  static constexpr double EXTINCTION_RATE = 0.1;   ///< Local extinction rate
+  static constexpr int COMPETITIVE_RANK = 0;       ///< Displaces every higher rank
+};
+
+/**
+ * @brief Species D - superior disperser with inferior competitive ability
+ */
+struct SuperiorDisperser {
+  static constexpr double COLONIZATION_RATE = 0.5; ///< Colonization rate
+  static constexpr double EXTINCTION_RATE = 0.1;   ///< Local extinction rate
+  static constexpr int COMPETITIVE_RANK = 1;       ///< Displaced by species C
+};
+
+/**
+ * @brief Compile-time community: an ordered list of species traits
+ * @tparam SPECIES Traits types; the i-th one is species id i
+ *
+ * The parameter of CompactWorldT.  Cell states follow CellState: 0 is
+ * empty, 1 is destroyed and species i is stored as state 2 + i, so the
+ * per-state tables below are indexed by the raw cell byte.  Everything is
+ * constexpr, so an engine instantiated on a SpeciesSet resolves rates and
+ * the displacement rule at compile time and Dispatch turns a species id
+ * into a compile-time constant.
+ */
+template <typename... SPECIES> struct SpeciesSet {
+  static constexpr size_t NUM_SPECIES = sizeof...(SPECIES);
+  /// Cell states: empty, destroyed, then one per species
+  static constexpr size_t NUM_STATES = NUM_SPECIES + 2;
+  static_assert(NUM_SPECIES >= 1, "A SpeciesSet needs at least one species");
+  static_assert(NUM_STATES <= 64, "State masks are 64 bits wide");
+
+  /// Traits type of species id I
+  template <size_t I>
+  using TraitsOf = std::tuple_element_t<I, std::tuple<SPECIES...>>;
+
+  /// Rates of every species, indexed by species id
+  static constexpr std::array<SpeciesParams, NUM_SPECIES> PARAMS = {
+      {{SPECIES::COLONIZATION_RATE, SPECIES::EXTINCTION_RATE}...}};
+
+  /// Competitive rank of every species, indexed by species id
+  static constexpr std::array<int, NUM_SPECIES> RANKS = {{SPECIES::COMPETITIVE_RANK...}};
+
+  /**
+   * @brief Check whether one species displaces another
+   * @param colonizer Species id of the colonizing organism
+   * @param occupant Species id of the organism in the target cell
+   */
+  static constexpr bool Displaces(size_t colonizer, size_t occupant) {
+    return RANKS[colonizer] < RANKS[occupant];
+  }
+
+  /**
+   * @brief Cell states a species can colonize, as a mask over states
+   * @param colonizer Species id
+   * @return Bit s is set if a cell in state s is a valid target
+   */
+  static constexpr uint64_t OpenStates(size_t colonizer) {
+    uint64_t mask = uint64_t(1) << 0; // Empty
+    for (size_t occupant = 0; occupant < NUM_SPECIES; occupant++) {
+      if (Displaces(colonizer, occupant))
+        mask |= uint64_t(1) << (occupant + 2);
+    }
+    return mask;
+  }
+
+  /**
+   * @brief Cell states no colonizer can enter: destroyed and every species
+   *        that no other species displaces
+   */
+  static constexpr uint64_t ClosedStates() {
+    uint64_t open = 0;
+    for (size_t colonizer = 0; colonizer < NUM_SPECIES; colonizer++) {
+      open |= OpenStates(colonizer);
+    }
+    return ~open & ((uint64_t(1) << NUM_STATES) - 1);
+  }
+
+  /**
+   * @brief Call a function with a species id as a compile-time constant
+   * @param species Species id, less than NUM_SPECIES
+   * @param func Called as func(std::integral_constant<size_t, species>{});
+   *        must return a default-constructible value
+   * @return What func returned
+   *
+   * Expands to one comparison per species, each arm with its own inlined
+   * copy of func.
+   */
+  template <typename FUNC> static auto Dispatch(size_t species, FUNC &&func) {
+    return DispatchImpl(species, func, std::make_index_sequence<NUM_SPECIES>{});
+  }
+
+private:
+  template <typename FUNC, size_t... I>
+  static auto DispatchImpl(size_t species, FUNC &func, std::index_sequence<I...>) {
+    decltype(func(std::integral_constant<size_t, 0>{})) result{};
+    ((species == I ? (result = func(std::integral_constant<size_t, I>{}), true)
+                   : false) ||
+     ...);
+    return result;
+  }
+};
+
+/// The two-species competition-colonization community of the model
+using CompetitionColonization = SpeciesSet<SuperiorCompetitor, SuperiorDisperser>;
+
+#endif
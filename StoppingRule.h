@@ -0,0 +1,126 @@
+#ifndef STOPPING_RULE_H
+#define STOPPING_RULE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief When a run may stop before its last update
+ */
+enum class ExtinctionStop {
+  OFF = 0, ///< Never stop on extinction
+  ALL = 1, ///< Stop once every species is extinct (absorbing: nothing can return)
+  ANY = 2  ///< Stop once any species is extinct
+};
+
+/**
+ * @brief Settings of the stopping rules of a run
+ */
+struct StoppingSettings {
+  ExtinctionStop extinction = ExtinctionStop::OFF;
+  int equilibrium_window = 0;        ///< Updates per block of the stationarity test (0 = off)
+  double equilibrium_tolerance = 0.01; ///< Largest relative change of block means
+
+  /**
+   * @brief Check whether any rule can stop a run early
+   */
+  bool IsEnabled() const {
+    return extinction != ExtinctionStop::OFF || equilibrium_window > 0;
+  }
+};
+
+/**
+ * @brief Decides after each update whether a run can stop
+ *
+ * Extinction is checked directly on the species counts.  The stationarity
+ * test splits the updates after destruction has finished into consecutive
+ * blocks of equilibrium_window updates and stops when, for every species,
+ * the mean count of the latest block differs from that of the block before
+ * by at most equilibrium_tolerance times the larger mean (at least one
+ * cell).  Each check is O(species); the caller supplies the counts.
+ */
+class StoppingRule {
+private:
+  StoppingSettings settings;
+  std::vector<double> block_sums;    ///< Per-species sums of the current block
+  std::vector<double> previous_means; ///< Per-species means of the last full block
+  int block_samples = 0;              ///< Updates in the current block
+  bool has_previous = false;          ///< previous_means holds a full block
+
+public:
+  explicit StoppingRule(const StoppingSettings &_settings = StoppingSettings())
+      : settings(_settings) {}
+
+  bool IsEnabled() const { return settings.IsEnabled(); }
+
+  /**
+   * @brief Check whether the run can stop after this update
+   * @param counts Cell counts, species first (CountCells)
+   * @param num_species Number of leading species entries in counts
+   * @param destruction_active True while destruction rounds remain
+   * @return True if a rule says the run is finished
+   */
+  template <typename COUNTS>
+  bool Check(const COUNTS &counts, size_t num_species, bool destruction_active) {
+    if (settings.extinction != ExtinctionStop::OFF) {
+      size_t extinct = 0;
+      for (size_t species = 0; species < num_species; species++) {
+        extinct += counts[species] == 0;
+      }
+      if (extinct == num_species ||
+          (settings.extinction == ExtinctionStop::ANY && extinct > 0))
+        return true;
+    }
+    if (settings.equilibrium_window <= 0)
+      return false;
+    if (destruction_active) {
+      block_samples = 0;
+      has_previous = false;
+      return false;
+    }
+
+    if (block_samples == 0)
+      block_sums.assign(num_species, 0.0);
+    for (size_t species = 0; species < num_species; species++) {
+      block_sums[species] += counts[species];
+    }
+    if (++block_samples < settings.equilibrium_window)
+      return false;
+
+    bool stationary = has_previous;
+    for (size_t species = 0; species < num_species; species++) {
+      double mean = block_sums[species] / block_samples;
+      if (has_previous) {
+        double scale = std::max({mean, previous_means[species], 1.0});
+        stationary = stationary && std::abs(mean - previous_means[species]) <=
+                                       settings.equilibrium_tolerance * scale;
+      }
+      block_sums[species] = mean;
+    }
+    previous_means.swap(block_sums);
+    has_previous = true;
+    block_samples = 0;
+    return stationary;
+  }
+
+  /**
+   * @brief Check whether stopping now leaves the final counts unchanged
+   * @param counts Cell counts at the stop, species first
+   * @param num_species Number of leading species entries in counts
+   *
+   * True when every species is extinct: no organism can return, so the
+   * rest of the run would only apply the remaining destruction.
+   */
+  template <typename COUNTS>
+  static bool IsAbsorbing(const COUNTS &counts, size_t num_species) {
+    for (size_t species = 0; species < num_species; species++) {
+      if (counts[species] != 0)
+        return false;
+    }
+    return true;
+  }
+};
+
+#endif
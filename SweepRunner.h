@@ -0,0 +1,84 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+ * @brief Derive a reproducible per-job random seed
+ * @param base_seed Seed from the configuration
+ * @param point Index of the parameter point
+ * @param replicate Replicate number at that point
+ * @return Positive seed suitable for emp::Random
+ *
+ * Uses the SplitMix64 finalizer so neighbouring jobs get unrelated seeds.
+ * The seed depends only on its arguments, never on which thread runs the job.
+ */
+inline int DeriveSeed(int base_seed, uint64_t point, uint64_t replicate) {
+  uint64_t z = static_cast<uint64_t>(base_seed);
+  for (uint64_t key : {point, replicate}) {
+    z += 0x9e3779b97f4a7c15ULL + key;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+  }
+  // emp::Random treats non-positive seeds as "seed from the clock"
+  return static_cast<int>(z % 2147483646ULL) + 1;
+}
+
+/**
+ * @brief Runs independent sweep jobs on a thread pool
+ *
+ * Each job is run exactly once on some worker; results are handed to the
+ * commit callback strictly in job order (0, 1, 2, ...) as soon as every
+ * earlier job has finished.  Output therefore streams while the sweep runs
+ * and is identical for any number of threads.
+ */
+class SweepRunner {
+private:
+  ThreadPool pool;
+
+public:
+  /**
+   * @brief Construct a runner
+   * @param num_threads Threads to use (0 = all cores)
+   */
+  explicit SweepRunner(size_t num_threads = 0) : pool(num_threads) {}
+
+  /**
+   * @brief Get the number of threads jobs are spread over
+   */
+  size_t GetNumThreads() const { return pool.GetNumThreads(); }
+
+  /**
+   * @brief Run all jobs and commit their results in order
+   * @param num_jobs Number of jobs
+   * @param run_job Callable RESULT(size_t job_id); must not share mutable state
+   * @param commit_job Callable void(size_t job_id, RESULT &); called serially
+   */
+  template <typename RESULT, typename RUN_FUN, typename COMMIT_FUN>
+  void Run(size_t num_jobs, RUN_FUN run_job, COMMIT_FUN commit_job) {
+    std::vector<RESULT> results(num_jobs);
+    std::vector<char> finished(num_jobs, 0);
+    size_t next_commit = 0;
+    std::mutex commit_mutex;
+
+    pool.ParallelFor(num_jobs, [&](size_t job_id) {
+      RESULT result = run_job(job_id);
+
+      std::lock_guard<std::mutex> lock(commit_mutex);
+      results[job_id] = std::move(result);
+      finished[job_id] = 1;
+      while (next_commit < num_jobs && finished[next_commit]) {
+        commit_job(next_commit, results[next_commit]);
+        results[next_commit] = RESULT(); // release committed data
+        next_commit++;
+      }
+    });
+  }
+};
+
+#endif
@@ -0,0 +1,416 @@
+#ifndef SWEEP_SPEC_H
+#define SWEEP_SPEC_H
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommunityWorld.h"
+#include "CompactWorld.h"
+#include "ConfigSetup.h"
+#include "HabitatMask.h"
+#include "Landscape.h"
+#include "Neighborhood.h"
+#include "StoppingRule.h"
+
+/**
+ * @brief Parse one number of a sweep axis
+ * @param part Text of the number; surrounding whitespace is ignored
+ * @param value Set to the number
+ * @return False unless the whole text is one finite number
+ */
+inline bool ParseSweepValue(const std::string &part, double &value) {
+  const size_t first = part.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos)
+    return false;
+  const size_t last = part.find_last_not_of(" \t\r\n");
+  const std::string text = part.substr(first, last - first + 1);
+  size_t idx = 0;
+  try {
+    value = std::stod(text, &idx);
+  } catch (...) {
+    return false;
+  }
+  return idx == text.size() && std::isfinite(value);
+}
+
+/**
+ * @brief Parse one sweep axis specification
+ * @param spec A single value "0.5", a list "0,1" or a range "0.25:0.75:0.01"
+ * @param values Filled with the expanded values
+ * @return False if the specification is malformed, including any number
+ *         followed by other characters ("0.5x", "1e")
+ *
+ * Range values are computed as min + i * step rather than by accumulation,
+ * so 0.25:0.75:0.01 yields exactly 51 values including both ends.
+ */
+inline bool ParseSweepAxis(const std::string &spec, std::vector<double> &values) {
+  values.clear();
+  if (spec.find(':') != std::string::npos) {
+    std::stringstream ss(spec);
+    std::string part;
+    std::vector<double> bounds;
+    double value;
+    while (std::getline(ss, part, ':')) {
+      if (!ParseSweepValue(part, value))
+        return false;
+      bounds.push_back(value);
+    }
+    if (bounds.size() != 3 || bounds[2] <= 0.0 || bounds[1] < bounds[0])
+      return false;
+    size_t count = static_cast<size_t>(
+        std::floor((bounds[1] - bounds[0]) / bounds[2] + 1e-9)) + 1;
+    for (size_t i = 0; i < count; i++) {
+      values.push_back(bounds[0] + i * bounds[2]);
+    }
+    return true;
+  }
+
+  std::stringstream ss(spec);
+  std::string part;
+  double value;
+  while (std::getline(ss, part, ',')) {
+    if (!ParseSweepValue(part, value))
+      return false;
+    values.push_back(value);
+  }
+  return !values.empty();
+}
+
+/**
+ * @brief Parse a competition matrix
+ * @param spec n rows of n '0'/'1' characters separated by ';', e.g. "01;00"
+ * @param n Number of species
+ * @param displaces Filled row-major: displaces[i * n + j] is 1 if i displaces j
+ * @return False if the matrix is malformed or a species displaces itself
+ */
+inline bool ParseCompetitionMatrix(const std::string &spec, size_t n,
+                                   std::vector<uint8_t> &displaces) {
+  displaces.clear();
+  std::stringstream ss(spec);
+  std::string row;
+  while (std::getline(ss, row, ';')) {
+    if (row.size() != n)
+      return false;
+    for (char entry : row) {
+      if (entry != '0' && entry != '1')
+        return false;
+      displaces.push_back(entry == '1');
+    }
+  }
+  if (displaces.size() != n * n)
+    return false;
+  for (size_t i = 0; i < n; i++) {
+    if (displaces[i * n + i])
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief One parameter combination of a sweep
+ */
+struct SweepPoint {
+  int pattern;              ///< Destruction pattern (LandscapePattern)
+  double percent_destroyed; ///< Fraction of habitat destroyed
+  int rounds;               ///< Destruction rounds (0 = immediate)
+};
+
+/**
+ * @brief One unit of work: a parameter point and a replicate number
+ */
+struct SweepJob {
+  size_t point_id;   ///< Index of the point in the full (unsharded) sweep
+  SweepPoint point;  ///< Parameters of the run
+  size_t replicate;  ///< Replicate number at this point
+};
+
+/**
+ * @brief Declarative description of a native parameter sweep
+ *
+ * Expands the cartesian product patterns x destroyed x rounds, with
+ * replicates as the innermost loop.  Sharding splits the point list into
+ * SHARD_COUNT contiguous blocks; point ids (and therefore seeds) always
+ * refer to the full sweep, so sharded runs concatenate to the unsharded one.
+ */
+class SweepSpec {
+private:
+  std::vector<SweepPoint> points; ///< All points of the full sweep
+  size_t first_point = 0;         ///< First point of this shard
+  size_t num_shard_points = 0;    ///< Points in this shard
+
+public:
+  int grid_width = 50;
+  int grid_height = 50;
+  int updates = 1000;
+  double initial_occupancy = 0.5;
+  size_t replicates = 1;
+  NeighborhoodType neighborhood = NeighborhoodType::MOORE;
+  bool wrap_edges = false;
+  UpdateMode update_mode = UpdateMode::ASYNCHRONOUS;
+  int tile_size = 256;
+  size_t sweep_threads = 0;  ///< Threads running jobs (0 = all cores)
+  size_t update_threads = 1; ///< Threads of each run's parallel updates
+  RngMode rng_mode = RngMode::SHARED;
+  int landscape_seed = -1;   ///< Seed of shared landscapes (-1 = each run draws its own)
+  int replicate_summary = 0; ///< 0 = per-run rows only, 1 = also summaries, 2 = summaries only
+  StoppingSettings stopping; ///< Early-termination rules of every run
+  std::shared_ptr<const HabitatMask> habitat_mask; ///< Shared by every job, if set
+  CommunitySpec community; ///< Species of ENGINE 3
+
+  /**
+   * @brief Build the sweep from configuration
+   * @param config Loaded configuration
+   * @param error Set to a description of the problem on failure
+   * @return False if any axis or shard setting is invalid
+   */
+  bool Configure(const MyConfigType &config, std::string &error) {
+    std::vector<double> patterns, destroyed, rounds;
+    if (!ParseAxis(config.SWEEP_PATTERNS(), config.DESTRUCTION_PATTERN(),
+                   "SWEEP_PATTERNS", patterns, error) ||
+        !ParseAxis(config.SWEEP_DESTROYED(), config.PERCENT_DESTROYED(),
+                   "SWEEP_DESTROYED", destroyed, error) ||
+        !ParseAxis(config.SWEEP_ROUNDS(), config.DESTRUCTION_ROUNDS(),
+                   "SWEEP_ROUNDS", rounds, error)) {
+      return false;
+    }
+
+    for (double pattern : patterns) {
+      if (pattern != std::floor(pattern)) {
+        error = "SWEEP_PATTERNS values must be integers";
+        return false;
+      }
+      if (std::lround(pattern) < 0 || std::lround(pattern) >= NUM_LANDSCAPE_PATTERNS) {
+        error = "Destruction patterns must be in [0, " +
+                std::to_string(NUM_LANDSCAPE_PATTERNS) + ")";
+        return false;
+      }
+    }
+    for (double fraction : destroyed) {
+      if (!(fraction >= 0.0 && fraction <= 1.0)) {
+        error = "Fractions destroyed must be in [0, 1]";
+        return false;
+      }
+    }
+    for (double round_count : rounds) {
+      if (round_count != std::floor(round_count)) {
+        error = "SWEEP_ROUNDS values must be integers";
+        return false;
+      }
+      if (std::lround(round_count) < 0) {
+        error = "Destruction rounds must not be negative";
+        return false;
+      }
+    }
+
+    points.clear();
+    for (double pattern : patterns) {
+      for (double fraction : destroyed) {
+        for (double round_count : rounds) {
+          points.push_back({static_cast<int>(std::lround(pattern)), fraction,
+                            static_cast<int>(std::lround(round_count))});
+        }
+      }
+    }
+
+    grid_width = config.GRID_WIDTH();
+    grid_height = config.GRID_HEIGHT();
+    updates = config.UPDATES();
+    initial_occupancy = config.INITIAL_OCCUPANCY();
+    replicates = std::max(1, config.REPLICATES());
+    neighborhood = config.NEIGHBORHOOD() == 1 ? NeighborhoodType::VON_NEUMANN
+                                              : NeighborhoodType::MOORE;
+    wrap_edges = config.WRAP_EDGES() != 0;
+    landscape_seed = config.LANDSCAPE_SEED();
+    replicate_summary = config.REPLICATE_SUMMARY();
+    if (replicate_summary < 0 || replicate_summary > 2) {
+      error = "REPLICATE_SUMMARY must be 0 (off), 1 (with per-run rows) or 2 (summary only)";
+      return false;
+    }
+    if (config.STOP_ON_EXTINCTION() < 0 || config.STOP_ON_EXTINCTION() > 2) {
+      error = "STOP_ON_EXTINCTION must be 0 (never), 1 (all species) or 2 (any species)";
+      return false;
+    }
+    stopping.extinction = static_cast<ExtinctionStop>(config.STOP_ON_EXTINCTION());
+    stopping.equilibrium_window = config.EQUILIBRIUM_WINDOW();
+    stopping.equilibrium_tolerance = config.EQUILIBRIUM_TOLERANCE();
+    if (stopping.equilibrium_window < 0 || stopping.equilibrium_tolerance < 0) {
+      error = "EQUILIBRIUM_WINDOW and EQUILIBRIUM_TOLERANCE must not be negative";
+      return false;
+    }
+    if (grid_width <= 0 || grid_height <= 0 || updates < 0) {
+      error = "GRID_WIDTH and GRID_HEIGHT must be positive and UPDATES not negative";
+      return false;
+    }
+    if (!(initial_occupancy >= 0.0 && initial_occupancy <= 1.0)) {
+      error = "INITIAL_OCCUPANCY must be in [0, 1]";
+      return false;
+    }
+    habitat_mask.reset();
+    if (!config.HABITAT_MASK().empty()) {
+      habitat_mask = HabitatMask::Open(config.HABITAT_MASK(), grid_width, grid_height, error);
+      if (!habitat_mask)
+        return false;
+      grid_width = habitat_mask->GetWidth();
+      grid_height = habitat_mask->GetHeight();
+    }
+
+    if (config.ENGINE() < 0 || config.ENGINE() > 3) {
+      error = "ENGINE must be 0 (organisms), 1 (compact), 2 (event-driven) or 3 (community)";
+      return false;
+    }
+
+    if (config.UPDATE_MODE() < 0 || config.UPDATE_MODE() > 2) {
+      error = "UPDATE_MODE must be 0 (asynchronous), 1 (tiled) or 2 (synchronous)";
+      return false;
+    }
+    update_mode = static_cast<UpdateMode>(config.UPDATE_MODE());
+    if (update_mode != UpdateMode::ASYNCHRONOUS && config.ENGINE() != 1) {
+      error = "UPDATE_MODE other than 0 needs ENGINE 1 (compact grid)";
+      return false;
+    }
+    tile_size = config.TILE_SIZE();
+    sweep_threads = static_cast<size_t>(std::max(0, config.NUM_THREADS()));
+    update_threads = static_cast<size_t>(std::max(0, config.UPDATE_THREADS()));
+    SplitThreads();
+
+    if (config.RNG_MODE() < 0 || config.RNG_MODE() > 1) {
+      error = "RNG_MODE must be 0 (shared generator) or 1 (counter-based)";
+      return false;
+    }
+    rng_mode = static_cast<RngMode>(config.RNG_MODE());
+    if (rng_mode != RngMode::SHARED && config.ENGINE() == 2) {
+      error = "RNG_MODE 1 needs ENGINE 0, 1 or 3 (the event-driven engine has no per-cell draws)";
+      return false;
+    }
+
+    if (config.ENGINE() == 3 && !ConfigureCommunity(config, error))
+      return false;
+
+    int shard_count = config.SHARD_COUNT();
+    int shard_index = config.SHARD_INDEX();
+    if (shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+      error = "SHARD_INDEX must be in [0, SHARD_COUNT)";
+      return false;
+    }
+    first_point = points.size() * shard_index / shard_count;
+    num_shard_points = points.size() * (shard_index + 1) / shard_count - first_point;
+    return true;
+  }
+
+  /**
+   * @brief Get the number of points in the full sweep
+   */
+  size_t GetNumPoints() const { return points.size(); }
+
+  /**
+   * @brief Get the number of jobs in this shard
+   */
+  size_t GetNumJobs() const { return num_shard_points * replicates; }
+
+  /**
+   * @brief Get a job of this shard
+   * @param job_id Index in [0, GetNumJobs())
+   * @return The job's point and replicate
+   */
+  SweepJob GetJob(size_t job_id) const {
+    size_t point_id = first_point + job_id / replicates;
+    return {point_id, points[point_id], job_id % replicates};
+  }
+
+private:
+  /**
+   * @brief Share the cores between concurrent jobs and each job's updates
+   *
+   * Every sweep thread runs its own update pool, so the two counts multiply.
+   * A count of 0 takes the cores the other leaves (with both 0, the updates
+   * get every core and jobs run one at a time), and update threads are
+   * reduced so that the product does not exceed the cores.  Results do not
+   * depend on either count.
+   */
+  void SplitThreads() {
+    if (update_mode == UpdateMode::ASYNCHRONOUS) {
+      update_threads = 1;
+      return;
+    }
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    if (update_threads == 0)
+      update_threads = sweep_threads == 0 ? cores : cores / sweep_threads;
+    if (sweep_threads == 0)
+      sweep_threads = cores / std::max<size_t>(1, update_threads);
+    sweep_threads = std::max<size_t>(1, sweep_threads);
+    update_threads = std::max<size_t>(1, std::min(update_threads, cores / sweep_threads));
+  }
+
+  /**
+   * @brief Build the ENGINE 3 community from the COMMUNITY group
+   *
+   * The .dyts time series and checkpoints store two species, so ENGINE 3
+   * runs without them.
+   */
+  bool ConfigureCommunity(const MyConfigType &config, std::string &error) {
+    std::vector<double> colonization, extinction;
+    if (!ParseSweepAxis(config.COLONIZATION_RATES(), colonization) ||
+        !ParseSweepAxis(config.EXTINCTION_RATES(), extinction)) {
+      error = "Cannot parse COLONIZATION_RATES or EXTINCTION_RATES";
+      return false;
+    }
+    const size_t n = colonization.size();
+    if (n > CommunityWorld::MAX_SPECIES) {
+      error = "COLONIZATION_RATES lists more than " +
+              std::to_string(CommunityWorld::MAX_SPECIES) + " species";
+      return false;
+    }
+    if (extinction.size() != 1 && extinction.size() != n) {
+      error = "EXTINCTION_RATES must have one value or one per species";
+      return false;
+    }
+    community.species.clear();
+    for (size_t i = 0; i < n; i++) {
+      double extinction_rate = extinction[extinction.size() == 1 ? 0 : i];
+      if (colonization[i] < 0.0 || colonization[i] > 1.0 || extinction_rate < 0.0 ||
+          extinction_rate > 1.0) {
+        error = "Community rates must be in [0, 1]";
+        return false;
+      }
+      community.species.push_back({colonization[i], extinction_rate});
+    }
+    if (config.COMPETITION_MATRIX().empty()) {
+      community.SetHierarchy();
+    } else if (!ParseCompetitionMatrix(config.COMPETITION_MATRIX(), n,
+                                       community.displaces)) {
+      error = "COMPETITION_MATRIX must be " + std::to_string(n) + " rows of " +
+              std::to_string(n) + " 0/1 entries separated by ';', with a 0 diagonal";
+      return false;
+    }
+
+    if (config.TIMESERIES_INTERVAL() > 0 || config.BURN_IN() > 0 ||
+        !config.LOAD_CHECKPOINT().empty()) {
+      error = "ENGINE 3 does not support time series, burn-in or checkpoints";
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Parse an axis, falling back to a single configured value
+   */
+  static bool ParseAxis(const std::string &spec, double fallback,
+                        const std::string &name, std::vector<double> &values,
+                        std::string &error) {
+    if (spec.empty()) {
+      values.assign(1, fallback);
+      return true;
+    }
+    if (!ParseSweepAxis(spec, values)) {
+      error = "Cannot parse " + name + " '" + spec + "'";
+      return false;
+    }
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads for data-parallel loops
+ *
+ * Workers are started once and reused by every ParallelFor call, so the
+ * pool is cheap enough to use inside a simulation loop.  The calling thread
+ * also takes part in the work, so a pool of N threads runs N-1 workers.
+ */
+class ThreadPool {
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start_cv; ///< Signals workers that a loop is ready
+  std::condition_variable done_cv;  ///< Signals the caller that workers finished
+
+  const std::function<void(size_t)> *task = nullptr; ///< Body of the current loop
+  size_t task_count = 0;            ///< Number of iterations in the current loop
+  std::atomic<size_t> next_index{0}; ///< Next iteration to hand out
+  size_t generation = 0;            ///< Incremented for every new loop
+  size_t busy_workers = 0;          ///< Workers still running the current loop
+  bool stopping = false;
+
+public:
+  /**
+   * @brief Construct a pool
+   * @param num_threads Total threads including the caller (0 = all cores)
+   */
+  explicit ThreadPool(size_t num_threads = 0) {
+    if (num_threads == 0) {
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 1; i < num_threads; i++) {
+      workers.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Destructor - stop and join all workers
+   */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    start_cv.notify_all();
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief Get the number of threads that run loop bodies
+   * @return Worker count plus the calling thread
+   */
+  size_t GetNumThreads() const { return workers.size() + 1; }
+
+  /**
+   * @brief Run fn(i) for every i in [0, count) and wait for completion
+   * @param count Number of iterations
+   * @param fn Loop body; iterations may run concurrently and in any order
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)> &fn) {
+    if (workers.empty() || count <= 1) {
+      for (size_t i = 0; i < count; i++) {
+        fn(i);
+      }
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      task = &fn;
+      task_count = count;
+      next_index = 0;
+      busy_workers = workers.size();
+      generation++;
+    }
+    start_cv.notify_all();
+
+    RunIterations(fn, count);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return busy_workers == 0; });
+    task = nullptr;
+  }
+
+private:
+  /**
+   * @brief Claim and run iterations until the loop is exhausted
+   */
+  void RunIterations(const std::function<void(size_t)> &fn, size_t count) {
+    for (size_t i = next_index++; i < count; i = next_index++) {
+      fn(i);
+    }
+  }
+
+  /**
+   * @brief Body of each worker thread
+   */
+  void WorkerLoop() {
+    size_t seen_generation = 0;
+    while (true) {
+      const std::function<void(size_t)> *current_task;
+      size_t current_count;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start_cv.wait(lock, [&]() {
+          return stopping || generation != seen_generation;
+        });
+        if (stopping)
+          return;
+        seen_generation = generation;
+        current_task = task;
+        current_count = task_count;
+      }
+
+      RunIterations(*current_task, current_count);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy_workers--;
+      }
+      done_cv.notify_one();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef TILE_LAYOUT_H
+#define TILE_LAYOUT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Split of a grid into rectangular tiles and conflict-free phases
+ *
+ * Tiles are near-equal rectangles of about tile_size x tile_size cells.
+ * They are coloured so that no two tiles of the same colour touch, including
+ * diagonally and across wrapped edges: two colours per axis, or three along
+ * a wrapped axis with an odd tile count.  A colour is a phase.  Work on a
+ * tile only touches the tile and its one-cell halo, and tiles of one phase
+ * have disjoint halos as long as every tile is at least 2 cells wide, so
+ * the tiles of a phase can run concurrently.
+ */
+class TileLayout {
+public:
+  /// Smallest tile edge; keeps every tile at least 2 cells wide
+  static constexpr int MIN_TILE_SIZE = 4;
+
+private:
+  int width = 0;
+  int height = 0;
+  int tiles_x = 0;
+  int tiles_y = 0;
+  std::vector<std::vector<size_t>> phases; ///< Tile ids of each phase
+
+public:
+  /**
+   * @brief Build the layout
+   * @param _width Grid width
+   * @param _height Grid height
+   * @param tile_size Requested tile edge (raised to MIN_TILE_SIZE)
+   * @param wrap True if the grid edges wrap
+   */
+  void Build(int _width, int _height, int tile_size, bool wrap) {
+    width = _width;
+    height = _height;
+    tile_size = std::max(tile_size, MIN_TILE_SIZE);
+    tiles_x = std::max(1, (width + tile_size - 1) / tile_size);
+    tiles_y = std::max(1, (height + tile_size - 1) / tile_size);
+
+    int colors_x = NumColors(tiles_x, wrap);
+    int colors_y = NumColors(tiles_y, wrap);
+    phases.assign(colors_x * colors_y, std::vector<size_t>());
+    for (int ty = 0; ty < tiles_y; ty++) {
+      for (int tx = 0; tx < tiles_x; tx++) {
+        int phase = Color(ty, tiles_y, wrap) * colors_x + Color(tx, tiles_x, wrap);
+        phases[phase].push_back(static_cast<size_t>(ty) * tiles_x + tx);
+      }
+    }
+  }
+
+  size_t GetNumTiles() const { return static_cast<size_t>(tiles_x) * tiles_y; }
+  int GetTilesX() const { return tiles_x; }
+  int GetTilesY() const { return tiles_y; }
+
+  /**
+   * @brief Get the tile ids of every phase, in processing order
+   */
+  const std::vector<std::vector<size_t>> &GetPhases() const { return phases; }
+
+  /**
+   * @brief Get the cell rectangle of a tile
+   * @param tile Tile id
+   * @param x0 Set to the first column
+   * @param x1 Set to one past the last column
+   * @param y0 Set to the first row
+   * @param y1 Set to one past the last row
+   */
+  void GetBounds(size_t tile, int &x0, int &x1, int &y0, int &y1) const {
+    int tx = static_cast<int>(tile % tiles_x);
+    int ty = static_cast<int>(tile / tiles_x);
+    x0 = Split(tx, width, tiles_x);
+    x1 = Split(tx + 1, width, tiles_x);
+    y0 = Split(ty, height, tiles_y);
+    y1 = Split(ty + 1, height, tiles_y);
+  }
+
+private:
+  /**
+   * @brief Start of part i when length is split into count near-equal parts
+   */
+  static int Split(int i, int length, int count) {
+    return static_cast<int>(static_cast<long long>(i) * length / count);
+  }
+
+  static int NumColors(int count, bool wrap) {
+    if (count == 1)
+      return 1;
+    return (wrap && count % 2 == 1) ? 3 : 2;
+  }
+
+  /**
+   * @brief Colour of tile index i along an axis
+   *
+   * Alternates 0/1; on a wrapped axis with an odd count the last tile gets
+   * colour 2 so it differs from both its neighbours (tile 0 and count-2).
+   */
+  static int Color(int i, int count, bool wrap) {
+    if (count == 1)
+      return 0;
+    if (wrap && count % 2 == 1 && i == count - 1)
+      return 2;
+    return i % 2;
+  }
+};
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BinaryIO.h"
+
+/**
+ * @brief Columns recorded for every time-series sample
+ */
+enum TimeSeriesColumn {
+  TS_UPDATE = 0,        ///< Updates completed when the sample was taken
+  TS_ROUND,             ///< Destruction rounds processed so far
+  TS_SPECIES_C,         ///< Cells occupied by species C
+  TS_SPECIES_D,         ///< Cells occupied by species D
+  TS_EMPTY,             ///< Available, unoccupied cells
+  TS_DESTROYED,         ///< Destroyed cells
+  TS_EXTINCTIONS,       ///< Local extinctions since the previous sample
+  TS_COLONIZATIONS,     ///< Successful colonizations since the previous sample
+  TS_NUM_COLUMNS
+};
+
+/// Column names, as written to the file header and the CSV converter
+inline constexpr const char *TIME_SERIES_COLUMN_NAMES[TS_NUM_COLUMNS] = {
+    "Update",    "Round",       "Species_C",     "Species_D",
+    "Empty",     "Destroyed",   "Extinctions",   "Colonizations"};
+
+/**
+ * @brief Parameters identifying one run in a time-series file
+ */
+struct TimeSeriesRunInfo {
+  int32_t pattern = 0;            ///< Destruction pattern
+  double percent_destroyed = 0.0; ///< Fraction of habitat destroyed
+  int32_t rounds = 0;             ///< Destruction rounds (0 = immediate)
+  uint32_t replicate = 0;         ///< Replicate number at this point
+  int32_t seed = 0;               ///< Seed the run used
+};
+
+/**
+ * @brief Byte-level encoding of the time-series file
+ *
+ * File layout (all integers little-endian):
+ *   header: "DYTS", uint32 version, uint32 flags, uint32 column count,
+ *           then each column name as a uint8 length and its characters
+ *   run:    int32 pattern, float64 destroyed, int32 rounds,
+ *           uint32 replicate, int32 seed, uint32 sample count,
+ *           then per column a uint32 byte length and the column bytes
+ *
+ * Columns are stored one after another rather than row by row.  Raw columns
+ * are int32 values; compressed columns (flag bit 0) store the difference
+ * from the previous value, zigzag-mapped and LEB128 varint coded, so slowly
+ * changing counts take one byte per sample.
+ */
+namespace TimeSeriesFormat {
+constexpr char MAGIC[4] = {'D', 'Y', 'T', 'S'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_COMPRESSED = 1;
+
+/**
+ * @brief Append a column in raw or delta-varint form
+ */
+inline void EncodeColumn(const std::vector<int32_t> &values, bool compress,
+                         std::vector<uint8_t> &out) {
+  if (!compress) {
+    for (int32_t value : values) {
+      PutU32(out, static_cast<uint32_t>(value));
+    }
+    return;
+  }
+  int64_t previous = 0;
+  for (int32_t value : values) {
+    int64_t delta = value - previous;
+    previous = value;
+    uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^
+                      static_cast<uint64_t>(delta >> 63);
+    while (zigzag >= 0x80) {
+      out.push_back(static_cast<uint8_t>(zigzag | 0x80));
+      zigzag >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(zigzag));
+  }
+}
+
+/**
+ * @brief Decode a column written by EncodeColumn
+ * @return False if the bytes do not hold exactly count values
+ */
+inline bool DecodeColumn(const uint8_t *in, const uint8_t *end, size_t count,
+                         bool compress, std::vector<int32_t> &values) {
+  values.clear();
+  values.reserve(count);
+  if (!compress) {
+    for (size_t i = 0; i < count; i++) {
+      uint32_t value;
+      if (!GetU32(in, end, value))
+        return false;
+      values.push_back(static_cast<int32_t>(value));
+    }
+    return in == end;
+  }
+  int64_t previous = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t zigzag = 0;
+    int shift = 0;
+    while (true) {
+      if (in == end || shift > 63)
+        return false;
+      uint8_t byte = *in++;
+      zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+      if (byte < 0x80)
+        break;
+    }
+    int64_t delta = static_cast<int64_t>(zigzag >> 1) ^
+                    -static_cast<int64_t>(zigzag & 1);
+    previous += delta;
+    values.push_back(static_cast<int32_t>(previous));
+  }
+  return in == end;
+}
+} // namespace TimeSeriesFormat
+
+/**
+ * @brief Collects the time series of one run in memory
+ *
+ * Recording only appends integers to per-column vectors; encoding happens
+ * once per run in Encode, so the simulation loop never formats text or
+ * touches the file.  A sample is taken every `interval` updates (and always
+ * at update 0 and at the last update); event columns hold the events since
+ * the previous sample.
+ */
+class TimeSeriesRecorder {
+private:
+  int interval = 1;
+  std::array<std::vector<int32_t>, TS_NUM_COLUMNS> columns;
+  uint64_t last_extinctions = 0;
+  uint64_t last_colonizations = 0;
+
+public:
+  /**
+   * @brief Construct a recorder
+   * @param _interval Updates between samples (at least 1)
+   * @param total_updates Expected run length, used to reserve memory
+   */
+  TimeSeriesRecorder(int _interval = 1, int total_updates = 0)
+      : interval(_interval < 1 ? 1 : _interval) {
+    size_t expected = total_updates > 0 ? total_updates / interval + 2 : 0;
+    for (std::vector<int32_t> &column : columns) {
+      column.reserve(expected);
+    }
+  }
+
+  /**
+   * @brief Check whether a sample is due
+   * @param update Updates completed so far
+   * @param total_updates Updates in the whole run
+   */
+  bool IsDue(int update, int total_updates) const {
+    return update % interval == 0 || update == total_updates;
+  }
+
+  /**
+   * @brief Append one sample
+   * @param update Updates completed so far
+   * @param round Destruction rounds processed so far
+   * @param counts Cell counts [species_c, species_d, empty, destroyed]
+   * @param extinctions Cumulative extinction events of the world
+   * @param colonizations Cumulative colonization events of the world
+   */
+  void Record(int update, int round, const std::array<int, 4> &counts,
+              uint64_t extinctions, uint64_t colonizations) {
+    columns[TS_UPDATE].push_back(update);
+    columns[TS_ROUND].push_back(round);
+    columns[TS_SPECIES_C].push_back(counts[0]);
+    columns[TS_SPECIES_D].push_back(counts[1]);
+    columns[TS_EMPTY].push_back(counts[2]);
+    columns[TS_DESTROYED].push_back(counts[3]);
+    columns[TS_EXTINCTIONS].push_back(
+        static_cast<int32_t>(extinctions - last_extinctions));
+    columns[TS_COLONIZATIONS].push_back(
+        static_cast<int32_t>(colonizations - last_colonizations));
+    last_extinctions = extinctions;
+    last_colonizations = colonizations;
+  }
+
+  /**
+   * @brief Get the number of samples recorded
+   */
+  size_t GetNumSamples() const { return columns[TS_UPDATE].size(); }
+
+  /**
+   * @brief Get one recorded column
+   */
+  const std::vector<int32_t> &GetColumn(TimeSeriesColumn column) const {
+    return columns[column];
+  }
+
+  /**
+   * @brief Encode the run as a file block
+   * @param info Parameters of the run
+   * @param compress True for delta-varint columns (must match the file flag)
+   * @return Bytes ready for TimeSeriesWriter::WriteBlock
+   */
+  std::vector<uint8_t> Encode(const TimeSeriesRunInfo &info, bool compress) const {
+    using namespace TimeSeriesFormat;
+    std::vector<uint8_t> block;
+    block.reserve(32 + GetNumSamples() * TS_NUM_COLUMNS * (compress ? 2 : 4));
+    PutU32(block, static_cast<uint32_t>(info.pattern));
+    PutF64(block, info.percent_destroyed);
+    PutU32(block, static_cast<uint32_t>(info.rounds));
+    PutU32(block, info.replicate);
+    PutU32(block, static_cast<uint32_t>(info.seed));
+    PutU32(block, static_cast<uint32_t>(GetNumSamples()));
+
+    std::vector<uint8_t> column_bytes;
+    for (const std::vector<int32_t> &column : columns) {
+      column_bytes.clear();
+      EncodeColumn(column, compress, column_bytes);
+      PutU32(block, static_cast<uint32_t>(column_bytes.size()));
+      block.insert(block.end(), column_bytes.begin(), column_bytes.end());
+    }
+    return block;
+  }
+};
+
+/**
+ * @brief Writes encoded runs to a time-series file
+ */
+class TimeSeriesWriter {
+private:
+  std::ofstream file;
+  bool compress = true;
+
+public:
+  /**
+   * @brief Create the file and write its header
+   * @param filename Output path
+   * @param _compress True to store delta-varint columns
+   */
+  TimeSeriesWriter(const std::string &filename, bool _compress)
+      : file(filename, std::ios::binary), compress(_compress) {
+    using namespace TimeSeriesFormat;
+    std::vector<uint8_t> header(MAGIC, MAGIC + 4);
+    PutU32(header, VERSION);
+    PutU32(header, compress ? FLAG_COMPRESSED : 0);
+    PutU32(header, TS_NUM_COLUMNS);
+    for (const char *name : TIME_SERIES_COLUMN_NAMES) {
+      size_t length = std::strlen(name);
+      header.push_back(static_cast<uint8_t>(length));
+      header.insert(header.end(), name, name + length);
+    }
+    WriteBlock(header);
+  }
+
+  /**
+   * @brief Check whether the file was opened successfully
+   */
+  bool IsOpen() const { return file.is_open(); }
+
+  /**
+   * @brief Check whether runs must be encoded compressed
+   */
+  bool IsCompressed() const { return compress; }
+
+  /**
+   * @brief Append an encoded run
+   */
+  void WriteBlock(const std::vector<uint8_t> &block) {
+    file.write(reinterpret_cast<const char *>(block.data()), block.size());
+  }
+};
+
+/**
+ * @brief Reads runs back from a time-series file
+ */
+class TimeSeriesReader {
+private:
+  std::vector<uint8_t> data;
+  const uint8_t *cursor = nullptr;
+  bool compress = false;
+  std::vector<std::string> column_names;
+
+public:
+  /**
+   * @brief Load a file and parse its header
+   * @param filename Input path
+   * @param error Set to a description of the problem on failure
+   * @return False if the file is missing or not a time-series file
+   */
+  bool Open(const std::string &filename, std::string &error) {
+    using namespace TimeSeriesFormat;
+    if (!ReadFileBytes(filename, data)) {
+      error = "Cannot open " + filename;
+      return false;
+    }
+    cursor = data.data();
+    const uint8_t *end = data.data() + data.size();
+
+    uint32_t version, flags, num_columns;
+    if (data.size() < 4 || std::memcmp(cursor, MAGIC, 4) != 0) {
+      error = filename + " is not a time-series file";
+      return false;
+    }
+    cursor += 4;
+    if (!GetU32(cursor, end, version) || !GetU32(cursor, end, flags) ||
+        !GetU32(cursor, end, num_columns) || version != VERSION) {
+      error = "Unsupported time-series header in " + filename;
+      return false;
+    }
+    compress = (flags & FLAG_COMPRESSED) != 0;
+    column_names.clear();
+    for (uint32_t i = 0; i < num_columns; i++) {
+      if (cursor == end || static_cast<size_t>(end - cursor) < 1u + *cursor) {
+        error = "Truncated column names in " + filename;
+        return false;
+      }
+      size_t length = *cursor++;
+      column_names.emplace_back(reinterpret_cast<const char *>(cursor), length);
+      cursor += length;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the column names stored in the header
+   */
+  const std::vector<std::string> &GetColumnNames() const { return column_names; }
+
+  /**
+   * @brief Check whether every run has been read
+   */
+  bool AtEnd() const { return cursor == data.data() + data.size(); }
+
+  /**
+   * @brief Read the next run
+   * @param info Filled with the run's parameters
+   * @param columns Filled with one vector per column
+   * @return False at the end of the file or on a truncated run
+   */
+  bool ReadRun(TimeSeriesRunInfo &info, std::vector<std::vector<int32_t>> &columns) {
+    using namespace TimeSeriesFormat;
+    const uint8_t *end = data.data() + data.size();
+    uint32_t pattern, rounds, seed, num_samples;
+    if (!GetU32(cursor, end, pattern) || !GetF64(cursor, end, info.percent_destroyed) ||
+        !GetU32(cursor, end, rounds) || !GetU32(cursor, end, info.replicate) ||
+        !GetU32(cursor, end, seed) || !GetU32(cursor, end, num_samples)) {
+      return false;
+    }
+    info.pattern = static_cast<int32_t>(pattern);
+    info.rounds = static_cast<int32_t>(rounds);
+    info.seed = static_cast<int32_t>(seed);
+
+    columns.resize(column_names.size());
+    for (std::vector<int32_t> &column : columns) {
+      uint32_t num_bytes;
+      if (!GetU32(cursor, end, num_bytes) ||
+          static_cast<size_t>(end - cursor) < num_bytes ||
+          !DecodeColumn(cursor, cursor + num_bytes, num_samples, compress, column)) {
+        return false;
+      }
+      cursor += num_bytes;
+    }
+    return true;
+  }
+};
+
+#endif
@@ -5,10 +5,21 @@
 #include "emp/data/DataFile.hpp"
 #include "emp/math/Random.hpp"
 #include "emp/math/random_utils.hpp"
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "Bitplane.h"
+#include "CounterRNG.h"
+#include "DenseIndexSet.h"
+#include "DestructionSchedule.h"
+#include "HabitatMask.h"
+#include "Landscape.h"
+#include "Neighborhood.h"
 #include "Org.h"
+#include "RandomBuffer.h"
 
 /**
  * @brief World class managing the habitat destruction simulation
@@ -20,16 +31,38 @@ class OrgWorld : public emp::World<Organism> {
 private:
   emp::Random &random;
   emp::Ptr<emp::Random> random_ptr;
-  std::vector<bool>
-      destroyed_cells; ///< Track which cells are destroyed habitat
+  Bitplane destroyed_cells; ///< Track which cells are destroyed habitat
+  Bitplane occupied_cells;  ///< Cells holding an organism (mirrors pop)
+  Bitplane species_c_cells; ///< Occupied cells whose organism is species C
+  DenseIndexSet live_cells; ///< Occupied cells, packed (mirrors occupied_cells)
+  emp::vector<size_t> update_order; ///< This update's processing order, reused
+  std::shared_ptr<const HabitatMask> habitat_mask; ///< Permanent non-habitat, if any
   int grid_width;
   int grid_height;
   
-  // New members for incremental destruction
-  emp::vector<size_t> cells_to_destroy; ///< Queue of cells scheduled for destruction
-  int destruction_rounds_remaining; ///< Rounds left for incremental destruction
-  int cells_per_round; ///< Number of cells to destroy each round
-  int extra_cells_first_rounds; ///< Extra cells to destroy in first rounds for remainder
+  // Incremental destruction
+  DestructionSchedule destruction_schedule; ///< Pre-shuffled cells and round cursor
+
+  // Neighbourhood used for colonization
+  Neighborhood neighborhood; ///< Precomputed neighbour offsets, rebuilt by InitializeGrid
+  NeighborhoodType neighborhood_type = NeighborhoodType::MOORE;
+  bool wrap_edges = false; ///< Toroidal wrapping instead of hard boundaries
+
+  // Population counters, kept in step with the bitplanes so CountCells is O(1)
+  std::array<int, 2> species_counts = {0, 0}; ///< Organisms of species C and D
+  int num_destroyed = 0;                      ///< Set bits of destroyed_cells
+  bool count_columns = false;                 ///< Maintain column_counts as well
+  std::vector<std::array<int, 3>> column_counts; ///< Per column: C, D, destroyed
+
+  // Event counters, cumulative since InitializeGrid
+  uint64_t extinction_events = 0;   ///< Organisms lost to local extinction
+  uint64_t colonization_events = 0; ///< Successful colonizations
+
+  // Random streams of the ecology updates
+  RngMode rng_mode = RngMode::SHARED;
+  CounterRNG counter_rng;        ///< Used in RngMode::COUNTER
+  DrawBuffer draw_buffer;        ///< This update's keyed Bernoulli draws, in bulk
+  uint64_t ecology_updates = 0;  ///< Updates completed since InitializeGrid (draw key)
 
 public:
   /**
@@ -43,8 +76,11 @@ public:
 
   /**
    * @brief Destructor - cleanup resources
+   *
+   * The remaining organisms are deleted by emp::World.
    */
   ~OrgWorld() {
+    random_ptr.Delete();
   }
 
   /**
@@ -53,168 +89,195 @@ public:
    * @param height Grid height
    */
   void InitializeGrid(int width, int height) {
+    habitat_mask.reset();
     grid_width = width;
     grid_height = height;
     SetPopStruct_Grid(width, height);
-    destroyed_cells.resize(width * height, false);
+    destroyed_cells.Resize(width * height);
+    occupied_cells.Resize(width * height);
+    species_c_cells.Resize(width * height);
+    // Rebuild the occupancy planes from pop in case the grid changed shape
+    occupied_cells.ClearAll();
+    species_c_cells.ClearAll();
+    live_cells.Resize(width * height);
+    for (size_t i = 0; i < GetSize(); i++) {
+      if (pop[i]) {
+        occupied_cells.Set(i);
+        species_c_cells.Set(i, pop[i]->GetSpecies() == 0);
+        live_cells.Insert(i);
+      }
+    }
+    Recount();
+    neighborhood.Build(width, height, neighborhood_type, wrap_edges);
+    extinction_events = 0;
+    colonization_events = 0;
+    ecology_updates = 0;
+  }
+
+  /**
+   * @brief Initialize the world on an external habitat mask
+   * @param mask Mapped mask; sets the grid size, and its non-habitat cells
+   *        are destroyed for the whole run
+   *
+   * The destroyed cells are filled from the mapping a word at a time; the
+   * mask itself is never written, so worlds on other threads can share it.
+   */
+  void InitializeGrid(std::shared_ptr<const HabitatMask> mask) {
+    InitializeGrid(mask->GetWidth(), mask->GetHeight());
+    SetHabitatMask(std::move(mask));
+    ResetDestroyed();
+  }
+
+  /**
+   * @brief Set the habitat mask without touching any cell
+   * @param mask Mask of the same size as the grid, or null for none
+   *
+   * Used after loading a checkpoint, whose cells already include the mask.
+   * Later destruction keeps the mask's cells destroyed.
+   */
+  void SetHabitatMask(std::shared_ptr<const HabitatMask> mask) {
+    habitat_mask = std::move(mask);
+  }
+
+  /**
+   * @brief Choose where ecology updates take their random numbers from
+   * @param mode SHARED (default): the world's emp::Random in processing
+   *             order; COUNTER: a CounterRNG keyed by (seed, update, cell, purpose)
+   * @param seed Key of the CounterRNG, normally the run's seed
+   *
+   * Setup (destruction, populating) always uses the emp::Random.
+   */
+  void SetRngMode(RngMode mode, uint64_t seed) {
+    rng_mode = mode;
+    counter_rng.SetSeed(seed);
+  }
+
+  /**
+   * @brief Get the number of ecology updates completed since InitializeGrid
+   */
+  uint64_t GetEcologyUpdates() const { return ecology_updates; }
+
+  /**
+   * @brief Overwrite the ecology update count (used by checkpoints)
+   */
+  void SetEcologyUpdates(uint64_t updates) { ecology_updates = updates; }
+
+  /**
+   * @brief Return true with probability p, for a draw of the current update
+   * @param pos Cell the draw belongs to (the key in RngMode::COUNTER)
+   * @param purpose What the draw is for (the key in RngMode::COUNTER)
+   * @param p Probability
+   */
+  bool DrawP(size_t pos, RngPurpose purpose, double p) {
+    if (rng_mode == RngMode::SHARED)
+      return random.P(p);
+    // Rates are not known up front here: a pair that misses the buffer is
+    // drawn directly and buffered from the next update on
+    bool value;
+    if (draw_buffer.Lookup(ecology_updates, pos, purpose, p, value))
+      return value;
+    draw_buffer.Register(purpose, p);
+    return counter_rng.P(p, ecology_updates, pos, purpose);
+  }
+
+  /**
+   * @brief Uniform integer in [0, max), for a draw of the current update
+   * @param pos Cell the draw belongs to (the key in RngMode::COUNTER)
+   * @param purpose What the draw is for (the key in RngMode::COUNTER)
+   * @param max Exclusive upper bound
+   */
+  size_t DrawUInt(size_t pos, RngPurpose purpose, size_t max) {
+    if (rng_mode == RngMode::COUNTER)
+      return counter_rng.GetUInt(static_cast<uint32_t>(max), ecology_updates, pos,
+                                 purpose);
+    return random.GetUInt(max);
   }
 
+  /**
+   * @brief Choose the colonization neighbourhood
+   * @param type Moore (8 neighbours, default) or von Neumann (4 neighbours)
+   * @param wrap True for toroidal wrapping, false for hard boundaries (default)
+   *
+   * Takes effect at the next InitializeGrid.
+   */
+  void SetNeighborhood(NeighborhoodType type, bool wrap) {
+    neighborhood_type = type;
+    wrap_edges = wrap;
+  }
+
+  /**
+   * @brief Get the configured colonization neighbourhood
+   */
+  NeighborhoodType GetNeighborhoodType() const { return neighborhood_type; }
+
+  /**
+   * @brief Check whether the grid edges wrap
+   */
+  bool GetWrapEdges() const { return wrap_edges; }
+
+  int GetWidth() const { return grid_width; }
+  int GetHeight() const { return grid_height; }
+
   /**
    * @brief Destroy habitat cells randomly
    * @param destruction_percentage Percentage of cells to destroy (0.0 to 1.0)
+   *
+   * Destroys exactly destruction_percentage of the cells (see
+   * LandscapeGenerator for this and the other patterns).
    */
   void DestroyHabitatRandom(double destruction_percentage) {
-    int total_cells = grid_width * grid_height;
-    int cells_to_destroy =
-        static_cast<int>(total_cells * destruction_percentage);
-
-    // Reset all cells to not destroyed
-    std::fill(destroyed_cells.begin(), destroyed_cells.end(), false);
-
-    // Randomly destroy cells
-    int destroyed_count = 0;
-    while (destroyed_count < cells_to_destroy) {
-      size_t pos = random.GetUInt(total_cells);
-      if (!destroyed_cells[pos]) {
-        destroyed_cells[pos] = true;
-        // Remove any organism at this position
-        if (IsOccupied(pos)) {
-          RemoveOrganism(pos);
-        }
-        destroyed_count++;
-      }
-    }
+    DestroyLandscape(LandscapeGenerator::Generate(
+        static_cast<int>(LandscapePattern::RANDOM), destruction_percentage,
+        grid_width, grid_height, random, habitat_mask.get()));
   }
 
   /**
- * @brief Destroy habitat cells in a gradient pattern
- * @param destruction_percentage Average percentage of cells to destroy (0.0 to 1.0)
- * 
- * Creates a gradient where the leftmost column has the highest destruction
- * and rightmost column has the lowest. The destruction probability varies
- * linearly across columns while maintaining the overall destruction percentage.
- */
-void DestroyHabitatGradient(double destruction_percentage) {
-    // Reset all cells to not destroyed
-    std::fill(destroyed_cells.begin(), destroyed_cells.end(), false);
-    
-    // Calculate the destruction range
-    // When average is 0.5, we want left at 0.75 and right at 0.25
-    // This gives a spread of 0.5 (0.75 - 0.25)
-    double spread = 0.5;
-    double max_destruction = destruction_percentage + (spread / 2.0);
-    double min_destruction = destruction_percentage - (spread / 2.0);
-    
-    // Ensure we stay within valid bounds [0, 1]
-    if (max_destruction > 1.0) {
-        double excess = max_destruction - 1.0;
-        max_destruction = 1.0;
-        min_destruction = std::max(0.0, min_destruction - excess);
-    }
-    if (min_destruction < 0.0) {
-        double deficit = -min_destruction;
-        min_destruction = 0.0;
-        max_destruction = std::min(1.0, max_destruction + deficit);
-    }
-    
-    // Process each column from left to right
-    for (int col = 0; col < grid_width; col++) {
-        // Calculate destruction probability for this column
-        // Linear interpolation from max (left) to min (right)
-        double column_destruction_prob = max_destruction - 
-            (col * (max_destruction - min_destruction) / (grid_width - 1));
-        
-        // Destroy cells in this column based on the probability
-        for (int row = 0; row < grid_height; row++) {
-            size_t pos = row * grid_width + col;
-            
-            if (random.P(column_destruction_prob)) {
-                destroyed_cells[pos] = true;
-                // Remove any organism at this position
-                if (IsOccupied(pos)) {
-                    RemoveOrganism(pos);
-                }
-          }
-        }
-      }
+   * @brief Destroy habitat cells in a gradient pattern
+   * @param destruction_percentage Average percentage of cells to destroy (0.0 to 1.0)
+   *
+   * Creates a gradient where the leftmost column has the highest destruction
+   * and rightmost column has the lowest. The destruction probability varies
+   * linearly across columns while maintaining the overall destruction percentage.
+   */
+  void DestroyHabitatGradient(double destruction_percentage) {
+    DestroyLandscape(LandscapeGenerator::Generate(
+        static_cast<int>(LandscapePattern::GRADIENT), destruction_percentage,
+        grid_width, grid_height, random, habitat_mask.get()));
   }
 
   /**
    * @brief Initialize incremental habitat destruction
    * @param destruction_percentage Percentage of cells to destroy (0.0 to 1.0)
    * @param rounds Number of rounds to spread destruction over (0 = immediate)
-   * @param pattern Destruction pattern: 0=Random, 1=Gradient
+   * @param pattern Destruction pattern (LandscapePattern): 0=Random,
+   *        1=Gradient, 2=Clumped, 3=Percolation
    */
   void InitializeIncrementalDestruction(double destruction_percentage, int rounds, int pattern) {
+    InitializeIncrementalDestruction(
+        LandscapeGenerator::Generate(pattern, destruction_percentage, grid_width,
+                                     grid_height, random, habitat_mask.get()),
+        rounds);
+  }
+
+  /**
+   * @brief Initialize habitat destruction from a generated landscape
+   * @param order Cells in destruction order (see LandscapeGenerator)
+   * @param rounds Number of rounds to spread destruction over (0 = immediate)
+   */
+  void InitializeIncrementalDestruction(emp::vector<size_t> order, int rounds) {
+    destruction_schedule.Clear();
     if (rounds == 0) {
-      // Immediate destruction using original methods
-      if (pattern == 0) {
-        DestroyHabitatRandom(destruction_percentage);
-      } else {
-        DestroyHabitatGradient(destruction_percentage);
-      }
+      DestroyLandscape(order);
       return;
     }
-    
-    // Reset destruction state
-    std::fill(destroyed_cells.begin(), destroyed_cells.end(), false);
-    cells_to_destroy.clear();
-    
-    int total_cells = grid_width * grid_height;
-    int total_to_destroy = static_cast<int>(total_cells * destruction_percentage);
-    
-    // Determine which cells to destroy based on pattern
-    if (pattern == 0) {
-      // Random pattern - create random order
-      emp::vector<size_t> all_cells;
-      for (size_t i = 0; i < total_cells; i++) {
-        all_cells.push_back(i);
-      }
-      emp::Shuffle(random, all_cells);
-      
-      // Take first total_to_destroy cells
-      for (int i = 0; i < total_to_destroy; i++) {
-        cells_to_destroy.push_back(all_cells[i]);
-      }
-    } else {
-      // Gradient pattern - calculate destruction probability per column
-      double spread = 0.5;
-      double max_destruction = destruction_percentage + (spread / 2.0);
-      double min_destruction = destruction_percentage - (spread / 2.0);
-      
-      // Ensure bounds
-      if (max_destruction > 1.0) {
-        double excess = max_destruction - 1.0;
-        max_destruction = 1.0;
-        min_destruction = std::max(0.0, min_destruction - excess);
-      }
-      if (min_destruction < 0.0) {
-        double deficit = -min_destruction;
-        min_destruction = 0.0;
-        max_destruction = std::min(1.0, max_destruction + deficit);
-      }
-      
-      // Select cells based on gradient probabilities
-      for (int col = 0; col < grid_width; col++) {
-        double column_destruction_prob = max_destruction - 
-            (col * (max_destruction - min_destruction) / (grid_width - 1));
-        
-        for (int row = 0; row < grid_height; row++) {
-          size_t pos = row * grid_width + col;
-          if (random.P(column_destruction_prob)) {
-            cells_to_destroy.push_back(pos);
-          }
-        }
-      }
-      
-      // Shuffle to randomize destruction order within the gradient pattern
-      emp::Shuffle(random, cells_to_destroy);
+    ResetDestroyed();
+    if (habitat_mask) {
+      // Generated landscapes already skip the mask; orders made without it
+      // (checkpoints, external landscapes) may not
+      habitat_mask->RemoveDestroyed(order);
     }
-    
-    // Calculate cells per round
-    destruction_rounds_remaining = rounds;
-    cells_per_round = cells_to_destroy.size() / rounds;
-    extra_cells_first_rounds = cells_to_destroy.size() % rounds;
+    // Spread the order evenly over the rounds
+    destruction_schedule.Reset(std::move(order), rounds);
   }
   
   /**
@@ -222,37 +285,68 @@ void DestroyHabitatGradient(double destruction_percentage) {
    * @return Number of cells destroyed this round
    */
   int ProcessIncrementalDestruction() {
-    if (destruction_rounds_remaining <= 0 || cells_to_destroy.empty()) {
-      return 0;
-    }
-    
-    // Calculate how many cells to destroy this round
-    int cells_this_round = cells_per_round;
-    if (extra_cells_first_rounds > 0) {
-      cells_this_round++;
-      extra_cells_first_rounds--;
-    }
-    
-    int destroyed_count = 0;
-    
-    // Destroy cells from the front of the queue
-    while (destroyed_count < cells_this_round && !cells_to_destroy.empty()) {
-      size_t pos = cells_to_destroy.front();
-      cells_to_destroy.erase(cells_to_destroy.begin());
-      
+    auto [first, last] = destruction_schedule.NextRound();
+    const emp::vector<size_t> &order = destruction_schedule.GetOrder();
+
+    for (size_t i = first; i < last; i++) {
+      size_t pos = order[i];
+
       // Destroy the cell
-      destroyed_cells[pos] = true;
+      SetDestroyed(pos);
       
       // Kill any organism at this position
       if (IsOccupied(pos)) {
         RemoveOrganism(pos);
       }
-      
-      destroyed_count++;
     }
-    
-    destruction_rounds_remaining--;
-    return destroyed_count;
+
+    return static_cast<int>(last - first);
+  }
+
+  /**
+   * @brief Jump incremental destruction to the start of any round
+   * @param round Round to jump to (0 = nothing destroyed yet)
+   *
+   * Jumping forward destroys every cell scheduled before that round and
+   * kills their occupants; jumping back restores those cells as empty habitat.
+   */
+  void JumpToDestructionRound(int round) {
+    size_t previous = destruction_schedule.SeekRound(round);
+    size_t target = destruction_schedule.GetCursor();
+    const emp::vector<size_t> &order = destruction_schedule.GetOrder();
+
+    for (size_t i = previous; i < target; i++) {
+      SetDestroyed(order[i]);
+      if (IsOccupied(order[i])) {
+        RemoveOrganism(order[i]);
+      }
+    }
+    for (size_t i = target; i < previous; i++) {
+      ClearDestroyed(order[i]);
+    }
+  }
+
+  /**
+   * @brief Get the incremental destruction schedule
+   * @return Schedule with the destruction order, current round and remaining cells
+   */
+  const DestructionSchedule &GetDestructionSchedule() const {
+    return destruction_schedule;
+  }
+
+  /**
+   * @brief Restore a destruction schedule without touching any cell
+   * @param order Cells in destruction order
+   * @param total_rounds Rounds the order is spread over
+   * @param round Rounds already processed
+   *
+   * Used when loading a checkpoint, whose cells already reflect the rounds
+   * processed so far.
+   */
+  void RestoreDestructionSchedule(emp::vector<size_t> order, int total_rounds,
+                                  int round) {
+    destruction_schedule.Reset(std::move(order), total_rounds);
+    destruction_schedule.SeekRound(round);
   }
   
   /**
@@ -260,7 +354,7 @@ void DestroyHabitatGradient(double destruction_percentage) {
    * @return True if there are still rounds of destruction remaining
    */
   bool IsIncrementalDestructionActive() const {
-    return destruction_rounds_remaining > 0;
+    return destruction_schedule.IsActive();
   }
 
   /**
@@ -269,7 +363,7 @@ void DestroyHabitatGradient(double destruction_percentage) {
    * @return True if cell is destroyed
    */
   bool IsDestroyed(size_t pos) const {
-    return pos < destroyed_cells.size() && destroyed_cells[pos];
+    return pos < destroyed_cells.GetSize() && destroyed_cells.Get(pos);
   }
 
   /**
@@ -278,33 +372,52 @@ void DestroyHabitatGradient(double destruction_percentage) {
    * @return True if cell is available habitat
    */
   bool IsAvailable(size_t pos) const {
-    return pos < destroyed_cells.size() && !destroyed_cells[pos];
+    return pos < destroyed_cells.GetSize() && !destroyed_cells.Get(pos);
   }
 
   /**
    * @brief Update all organisms for one simulation step
    */
   void UpdateEcology() {
-    // Process each organism
-    emp::vector<size_t> occupied_positions;
-    for (size_t i = 0; i < GetSize(); i++) {
-      if (IsOccupied(i) && !IsDestroyed(i)) {
-        occupied_positions.push_back(i);
-      }
+    // Collect occupied positions in increasing order, the order every
+    // engine shuffles, so a seed gives the same run on each.  A sparse
+    // population is copied from the packed set and sorted, in time
+    // proportional to the survivors; a dense one is read with a bit scan of
+    // the occupancy plane (destroyed cells are never occupied).
+    emp::vector<size_t> &occupied_positions = update_order;
+    occupied_positions.clear();
+    const size_t num_live = live_cells.GetSize();
+    const size_t sort_cost = num_live * (64 - __builtin_clzll(num_live | 1));
+    if (sort_cost < occupied_cells.GetNumWords()) {
+      occupied_positions.assign(live_cells.begin(), live_cells.end());
+      std::sort(occupied_positions.begin(), occupied_positions.end());
+    } else {
+      occupied_positions.reserve(num_live);
+      occupied_cells.ForEachSet(
+          [&occupied_positions](size_t i) { occupied_positions.push_back(i); });
     }
 
     // Manually shuffle for random processing order
-    for (size_t i = occupied_positions.size() - 1; i > 0; i--) {
-      size_t j = random.GetUInt(i + 1);
-      std::swap(occupied_positions[i], occupied_positions[j]);
+    if (rng_mode == RngMode::COUNTER) {
+      // Keyed swap indices and Bernoulli draws are made in bulk
+      KeyedShuffle(occupied_positions, counter_rng, ecology_updates, 0);
+      const uint64_t *occupied_words = occupied_cells.GetWords();
+      draw_buffer.Fill(counter_rng, ecology_updates, GetSize(),
+                       [occupied_words](size_t w) { return occupied_words[w] != 0; });
+    } else {
+      for (size_t i = occupied_positions.size(); i-- > 1;) {
+        size_t j = random.GetUInt(i + 1);
+        std::swap(occupied_positions[i], occupied_positions[j]);
+      }
     }
 
     // Process organisms for extinction and colonization
     for (size_t pos : occupied_positions) {
-      if (IsOccupied(pos)) {
+      if (occupied_cells.Get(pos)) {
         ProcessOrganism(pos);
       }
     }
+    ecology_updates++;
   }
 
   /**
@@ -322,42 +435,34 @@ void DestroyHabitatGradient(double destruction_percentage) {
       return;
 
     // First check if colonization occurs this round
-    if (!random.P(colonization_rate))
+    if (!DrawP(pos, RngPurpose::COLONIZATION, colonization_rate))
       return;
 
     // Get the colonizing organism's species
     int colonizer_species = pop[pos]->GetSpecies();
 
-    // Get neighboring positions
-    std::vector<size_t> neighbors =
-        GetNeighborPositions(pos, grid_width, grid_height);
+    // A neighbour is blocked if it is destroyed or holds an organism the
+    // colonizer cannot displace: species C is blocked by destroyed cells
+    // and other C, species D by destroyed and any occupied cell
+    const Bitplane &blocking =
+        colonizer_species == 0 ? species_c_cells : occupied_cells;
 
-    // Find all valid colonization targets
-    std::vector<size_t> valid_targets;
+    // Find all valid colonization targets among the precomputed neighbours
+    std::array<size_t, Neighborhood::MAX_NEIGHBORS> valid_targets;
+    size_t num_targets = 0;
     
-    for (size_t neighbor_pos : neighbors) {
-      if (IsDestroyed(neighbor_pos)) continue;
-      
-      if (colonizer_species == 0) {  // Species C (superior competitor)
-        // Can colonize empty cells and cells occupied by species D
-        if (!IsOccupied(neighbor_pos) || 
-            (IsOccupied(neighbor_pos) && pop[neighbor_pos]->GetSpecies() == 1)) {
-          valid_targets.push_back(neighbor_pos);
-        }
-      } else if (colonizer_species == 1) {  // Species D (superior disperser)
-        // Can only colonize empty cells
-        if (!IsOccupied(neighbor_pos)) {
-          valid_targets.push_back(neighbor_pos);
-        }
+    for (size_t neighbor_pos : neighborhood.GetNeighbors(pos)) {
+      if (!destroyed_cells.Get(neighbor_pos) && !blocking.Get(neighbor_pos)) {
+        valid_targets[num_targets++] = neighbor_pos;
       }
     }
     
     // If there are no valid targets, colonization fails
-    if (valid_targets.empty())
+    if (num_targets == 0)
       return;
     
     // Randomly select one target from valid options
-    size_t target_index = random.GetUInt(valid_targets.size());
+    size_t target_index = DrawUInt(pos, RngPurpose::TARGET, num_targets);
     size_t target_pos = valid_targets[target_index];
     
     // Remove existing organism if present (competitive displacement)
@@ -368,74 +473,196 @@ void DestroyHabitatGradient(double destruction_percentage) {
     // Create and place offspring
     emp::Ptr<Organism> offspring = pop[pos]->CreateOffspring();
     AddOrgAt(offspring, target_pos);
+    colonization_events++;
+  }
+
+  /**
+   * @brief Get the number of local extinctions since InitializeGrid
+   */
+  uint64_t GetExtinctionEvents() const { return extinction_events; }
+
+  /**
+   * @brief Get the number of successful colonizations since InitializeGrid
+   */
+  uint64_t GetColonizationEvents() const { return colonization_events; }
+
+  /**
+   * @brief Overwrite the cumulative event counters (used by checkpoints)
+   */
+  void SetEventCounts(uint64_t extinctions, uint64_t colonizations) {
+    extinction_events = extinctions;
+    colonization_events = colonizations;
   }
 
   /**
-   * @brief Remove organism from the world
+   * @brief Remove organism from the world and delete it
    * @param i Position index
+   *
+   * The organism's memory goes back to OrganismPool for the next offspring.
    */
   void RemoveOrganism(size_t i) {
     if (IsOccupied(i)) {
-      pop[i] = nullptr;
+      CountOrganism(i, GetSpecies(i), -1);
+      emp::World<Organism>::RemoveOrgAt(i);
+      occupied_cells.Clear(i);
+      live_cells.Erase(i);
+      species_c_cells.Clear(i);
     }
   }
 
+  /**
+   * @brief Place an organism, keeping the occupancy planes in sync
+   * @param new_org Organism to place
+   * @param pos Position to place it at
+   *
+   * Hides emp::World::AddOrgAt so every placement through OrgWorld
+   * updates the bitplanes.
+   */
+  void AddOrgAt(emp::Ptr<Organism> new_org, size_t pos) {
+    if (occupied_cells.Get(pos)) {
+      CountOrganism(pos, GetSpecies(pos), -1);
+    }
+    emp::World<Organism>::AddOrgAt(new_org, pos);
+    const int species = new_org->GetSpecies();
+    occupied_cells.Set(pos);
+    species_c_cells.Set(pos, species == 0);
+    live_cells.Insert(pos);
+    CountOrganism(pos, species, 1);
+  }
+
+  /**
+   * @brief Remove every organism from the grid
+   */
+  void RemoveAllOrganisms() {
+    while (!live_cells.IsEmpty()) {
+      RemoveOrganism(*live_cells.begin());
+    }
+  }
+
+  /**
+   * @brief Destroy a cell, killing any occupant
+   * @param pos Position to destroy
+   */
+  void DestroyCell(size_t pos) {
+    RemoveOrganism(pos);
+    SetDestroyed(pos);
+  }
+
+  /**
+   * @brief Return every cell to empty, intact habitat
+   */
+  void ClearGrid() {
+    RemoveAllOrganisms();
+    destroyed_cells.ClearAll();
+    Recount();
+  }
+
+  /**
+   * @brief Get the species occupying a cell
+   * @param pos Position of an occupied cell
+   * @return Species ID (0=c, 1=d)
+   */
+  int GetSpecies(size_t pos) const { return species_c_cells.Get(pos) ? 0 : 1; }
+
+  /**
+   * @brief List all available (non-destroyed) cells
+   * @return Positions in increasing order
+   */
+  std::vector<size_t> GetAvailableCells() const {
+    std::vector<size_t> available_cells;
+    available_cells.reserve(destroyed_cells.GetSize() - destroyed_cells.Count());
+    destroyed_cells.ForEachClear(
+        [&available_cells](size_t i) { available_cells.push_back(i); });
+    return available_cells;
+  }
+
+  /**
+   * @brief Get the packed destroyed-habitat plane
+   */
+  const Bitplane &GetDestroyedPlane() const { return destroyed_cells; }
+
+  /**
+   * @brief Get the packed occupied-cell plane
+   */
+  const Bitplane &GetOccupiedPlane() const { return occupied_cells; }
+
+  /**
+   * @brief Get the packed species-C plane
+   */
+  const Bitplane &GetSpeciesCPlane() const { return species_c_cells; }
+
   /**
    * @brief Get positions of all neighboring cells
    * @param pos Center position
-   * @param width Grid width
-   * @param height Grid height
    * @return Vector of neighboring positions
+   *
+   * Allocating convenience wrapper around the precomputed neighbourhood;
+   * TryColonize reads the table directly.
    */
-  std::vector<size_t> GetNeighborPositions(size_t pos, int width, int height) {
+  std::vector<size_t> GetNeighborPositions(size_t pos) const {
     std::vector<size_t> neighbors;
-    int x = pos % width;
-    int y = pos / width;
-
-    // Check all 8 neighbors
-    for (int dx = -1; dx <= 1; dx++) {
-      for (int dy = -1; dy <= 1; dy++) {
-        if (dx == 0 && dy == 0)
-          continue; // Skip center position
-
-        int nx = x + dx;
-        int ny = y + dy;
-
-        // Check bounds (no toroidal wrapping for this simulation)
-        if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-          size_t neighbor_pos = ny * width + nx;
-          neighbors.push_back(neighbor_pos);
-        }
-      }
+    for (size_t neighbor_pos : neighborhood.GetNeighbors(pos)) {
+      neighbors.push_back(neighbor_pos);
     }
     return neighbors;
   }
 
+  /**
+   * @brief Get the precomputed neighbours of a cell without allocating
+   * @param pos Center position
+   * @return View over the neighbouring positions
+   */
+  NeighborView GetNeighbors(size_t pos) const {
+    return neighborhood.GetNeighbors(pos);
+  }
+
   /**
    * @brief Count organisms of each species
    * @return Array with counts [species_c, species_d, empty, destroyed]
+   *
+   * O(1): the counters are updated by every placement, removal and
+   * destruction.  Destroyed cells are never occupied.
    */
-  std::array<int, 4> CountCells() {
-    int species_c = 0;
-    int species_d = 0;
-    int empty = 0;
-    int destroyed = 0;
+  std::array<int, 4> CountCells() const {
+    int empty = static_cast<int>(GetSize()) - num_destroyed - species_counts[0] -
+                species_counts[1];
+    return {species_counts[0], species_counts[1], empty, num_destroyed};
+  }
 
-    for (size_t i = 0; i < GetSize(); i++) {
-      if (IsDestroyed(i)) {
-        destroyed++;
-      } else if (!IsOccupied(i)) {
-        empty++;
-      } else {
-        int species = pop[i]->GetSpecies();
-        if (species == 0)
-          species_c++;
-        else if (species == 1)
-          species_d++;
+  /**
+   * @brief Turn per-column counting on or off
+   * @param enable If true, CountColumn becomes available; placements and
+   *        destruction then also update one column entry each
+   */
+  void SetColumnCounting(bool enable) {
+    count_columns = enable;
+    Recount();
+  }
+
+  bool IsColumnCounting() const { return count_columns; }
+
+  /**
+   * @brief Count the cells of one grid column, e.g. along a destruction gradient
+   * @param col Column in [0, GetWidth())
+   * @return Array with counts [species_c, species_d, empty, destroyed]
+   *
+   * O(1) with SetColumnCounting(true); otherwise the column is scanned.
+   */
+  std::array<int, 4> CountColumn(int col) const {
+    std::array<int, 3> column = {0, 0, 0};
+    if (count_columns) {
+      column = column_counts[col];
+    } else {
+      for (size_t pos = col; pos < GetSize(); pos += grid_width) {
+        if (destroyed_cells.Get(pos)) {
+          column[2]++;
+        } else if (occupied_cells.Get(pos)) {
+          column[GetSpecies(pos)]++;
+        }
       }
     }
-
-    return {species_c, species_d, empty, destroyed};
+    return {column[0], column[1], grid_height - column[0] - column[1] - column[2],
+            column[2]};
   }
 
 private:
@@ -450,6 +677,101 @@ private:
     // Process the organism using its ProcessInWorld method
     pop[pos]->ProcessInWorld(
         *this, pos); // where attempts at extinction and colonization happen
+
+    // Colonization never targets the colonizer's own cell, so an empty cell
+    // here means the organism went extinct
+    if (!occupied_cells.Get(pos)) {
+      extinction_events++;
+    }
+  }
+
+  /**
+   * @brief Adjust the counters for an organism placed (+1) or removed (-1)
+   */
+  void CountOrganism(size_t pos, int species, int delta) {
+    species_counts[species] += delta;
+    if (count_columns) {
+      column_counts[pos % grid_width][species] += delta;
+    }
+  }
+
+  /**
+   * @brief Mark a cell destroyed, counting it if it was habitat
+   */
+  void SetDestroyed(size_t pos) {
+    if (destroyed_cells.Get(pos))
+      return;
+    destroyed_cells.Set(pos);
+    num_destroyed++;
+    if (count_columns) {
+      column_counts[pos % grid_width][2]++;
+    }
+  }
+
+  /**
+   * @brief Return a cell to habitat, counting it if it was destroyed
+   */
+  void ClearDestroyed(size_t pos) {
+    if (!destroyed_cells.Get(pos))
+      return;
+    destroyed_cells.Clear(pos);
+    num_destroyed--;
+    if (count_columns) {
+      column_counts[pos % grid_width][2]--;
+    }
+  }
+
+  /**
+   * @brief Rebuild every counter from the bitplanes after a bulk change
+   */
+  void Recount() {
+    num_destroyed = static_cast<int>(destroyed_cells.Count());
+    const int occupied = static_cast<int>(occupied_cells.Count());
+    species_counts[0] = static_cast<int>(species_c_cells.Count());
+    species_counts[1] = occupied - species_counts[0];
+
+    column_counts.clear();
+    if (!count_columns)
+      return;
+    column_counts.assign(grid_width, {0, 0, 0});
+    destroyed_cells.ForEachSet([this](size_t i) { column_counts[i % grid_width][2]++; });
+    occupied_cells.ForEachSet(
+        [this](size_t i) { column_counts[i % grid_width][GetSpecies(i)]++; });
+  }
+
+  /**
+   * @brief Destroy exactly the cells of a landscape, killing their occupants
+   */
+  void DestroyLandscape(const emp::vector<size_t> &order) {
+    ResetDestroyed();
+    for (size_t pos : order) {
+      SetDestroyed(pos);
+      if (IsOccupied(pos)) {
+        RemoveOrganism(pos);
+      }
+    }
+  }
+
+  /**
+   * @brief Return destroyed cells to habitat, except those of the habitat mask
+   *
+   * Organisms on mask cells are removed.
+   */
+  void ResetDestroyed() {
+    if (!habitat_mask) {
+      destroyed_cells.ClearAll();
+      Recount();
+      return;
+    }
+    habitat_mask->FillDestroyedWords(destroyed_cells.GetWords());
+    const uint64_t *destroyed = destroyed_cells.GetWords();
+    const uint64_t *occupied = occupied_cells.GetWords();
+    for (size_t w = 0; w < destroyed_cells.GetNumWords(); w++) {
+      for (uint64_t bits = destroyed[w] & occupied[w]; bits; bits &= bits - 1) {
+        RemoveOrganism(w * 64 + __builtin_ctzll(bits));
+      }
+    }
+    Recount();
   }
 };
 
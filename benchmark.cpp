@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "CommunityWorld.h"
+#include "CompactWorld.h"
+#include "GillespieWorld.h"
+#include "Populate.h"
+#include "SweepSpec.h"
+#include "World.h"
+
+/**
+ * @brief Benchmark of the ecology hot path on every engine
+ *
+ * Times InitializeIncrementalDestruction, ProcessIncrementalDestruction,
+ * PopulateWithBothSpecies, UpdateEcology, TryColonize and CountCells over
+ * a grid of (engine, size, destruction fraction, pattern) cases and writes
+ * one CSV row per case and operation to standard output:
+ *
+ *   Engine,Width,Height,Destruction,Pattern,Operation,Calls,Seconds,
+ *   NsPerCall,NsPerCell,CallsPerSec,AllocsPerCall
+ *
+ * For UpdateEcology, CallsPerSec is updates/sec and NsPerCell is ns per
+ * cell-update.  Allocations are counted by replacing global operator new,
+ * including the over-aligned overloads.
+ *
+ * Options (lists use the sweep syntax: 1,2,3 or min:max:step):
+ *   --engines 0,1,2        0=OrgWorld, 1=CompactWorld, 2=GillespieWorld, 3=CommunityWorld
+ *   --sizes 50,256,1024,4096  square grid sizes
+ *   --destroyed 0,0.5,0.9  fractions of habitat destroyed
+ *   --patterns 0,1         0=random, 1=gradient, 2=clumped, 3=percolation
+ *   --rounds 10            incremental destruction rounds
+ *   --cell-updates 5e7     cell-updates timed per case (sets the update count)
+ *   --max-updates 100      cap on timed updates per case
+ *   --seed 1               random seed
+ *   --update-mode 0        CompactWorld update mode (0=asynchronous, 1=tiled, 2=synchronous)
+ *   --tile-size 256        tile edge for --update-mode 1
+ *   --update-threads 1     threads per world for --update-mode 1 and 2 (0=all cores)
+ *   --rng-mode 0           0=shared emp::Random, 1=counter-based (engines 0, 1 and 3)
+ *   --species 2            species of engine 3: a hierarchy with colonization
+ *                          rates spread over 0.2..0.8 and extinction 0.1
+ */
+
+namespace {
+std::atomic<size_t> allocation_count{0};
+}
+
+// Out of line, so GCC cannot pair an inlined malloc with a sized-delete free
+// and warn about mismatched allocation functions
+__attribute__((noinline)) void *operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void *operator new(size_t size, std::align_val_t align) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  const size_t alignment = static_cast<size_t>(align);
+  // aligned_alloc needs a size that is a multiple of the alignment
+  const size_t rounded = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+  if (void *ptr = std::aligned_alloc(alignment, rounded))
+    return ptr;
+  throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new[](size_t size, std::align_val_t align) {
+  return operator new(size, align);
+}
+__attribute__((noinline)) void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  operator delete(ptr);
+}
+
+/**
+ * @brief Settings of a benchmark run
+ */
+struct BenchOptions {
+  std::vector<double> engines = {0, 1, 2};
+  std::vector<double> sizes = {50, 256, 1024, 4096};
+  std::vector<double> destroyed = {0.0, 0.5, 0.9};
+  std::vector<double> patterns = {0, 1};
+  int rounds = 10;
+  double cell_updates = 5e7;
+  int max_updates = 100;
+  int seed = 1;
+  int update_mode = 0;
+  int tile_size = 256;
+  int update_threads = 1;
+  int rng_mode = 0;
+  int species = 2;
+};
+
+/**
+ * @brief One benchmark case
+ */
+struct BenchCase {
+  int engine;
+  int size;
+  double destroyed;
+  int pattern;
+};
+
+/**
+ * @brief Times a block of calls and writes its CSV row
+ */
+class BenchTimer {
+private:
+  const BenchCase &bench;
+  std::chrono::steady_clock::time_point start;
+  size_t start_allocations;
+
+public:
+  explicit BenchTimer(const BenchCase &_bench)
+      : bench(_bench), start(std::chrono::steady_clock::now()),
+        start_allocations(allocation_count.load(std::memory_order_relaxed)) {}
+
+  /**
+   * @brief Stop the timer and report
+   * @param operation Name of the timed operation
+   * @param calls Number of calls timed
+   * @param cells_per_call Cells each call covers (for NsPerCell)
+   */
+  void Report(const char *operation, size_t calls, double cells_per_call) {
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start).count();
+    size_t allocations =
+        allocation_count.load(std::memory_order_relaxed) - start_allocations;
+    double ns_per_call = calls ? seconds * 1e9 / calls : 0.0;
+    std::printf("%d,%d,%d,%g,%d,%s,%zu,%.6f,%.1f,%.4f,%.1f,%.2f\n", bench.engine,
+                bench.size, bench.size, bench.destroyed, bench.pattern, operation,
+                calls, seconds, ns_per_call,
+                cells_per_call > 0 ? ns_per_call / cells_per_call : 0.0,
+                seconds > 0 ? calls / seconds : 0.0,
+                calls ? static_cast<double>(allocations) / calls : 0.0);
+    std::fflush(stdout);
+  }
+};
+
+/**
+ * @brief Time TryColonize on currently occupied cells (rate 1 forces an attempt)
+ */
+template <typename WORLD>
+void BenchTryColonize(WORLD &world, const BenchCase &bench, size_t max_calls) {
+  std::vector<size_t> occupied;
+  for (size_t pos = 0; pos < world.GetSize() && occupied.size() < max_calls; pos++) {
+    if (world.IsOccupied(pos))
+      occupied.push_back(pos);
+  }
+  BenchTimer timer(bench);
+  for (size_t pos : occupied) {
+    world.TryColonize(pos, 1.0);
+  }
+  timer.Report("TryColonize", occupied.size(), 1.0);
+}
+
+/**
+ * @brief The event-driven engine has no per-cell colonization call
+ */
+void BenchTryColonize(GillespieWorld &, const BenchCase &, size_t) {}
+
+/**
+ * @brief Apply the update-mode and RNG options of the engines that have them
+ */
+template <typename WORLD> void ApplyUpdateMode(WORLD &, const BenchOptions &) {}
+
+void ApplyUpdateMode(OrgWorld &world, const BenchOptions &options) {
+  world.SetRngMode(static_cast<RngMode>(options.rng_mode), options.seed);
+}
+
+void ApplyUpdateMode(CompactWorld &world, const BenchOptions &options) {
+  world.SetUpdateMode(static_cast<UpdateMode>(options.update_mode), options.tile_size,
+                      static_cast<size_t>(std::max(0, options.update_threads)));
+  world.SetRngMode(static_cast<RngMode>(options.rng_mode), options.seed);
+}
+
+void ApplyUpdateMode(CommunityWorld &world, const BenchOptions &options) {
+  world.SetRngMode(static_cast<RngMode>(options.rng_mode), options.seed);
+}
+
+/**
+ * @brief Competition-colonization trade-off community for engine 3
+ * @param num_species Number of species; species 0 is the best competitor
+ *        and the worst disperser
+ */
+CommunitySpec TradeOffCommunity(int num_species) {
+  CommunitySpec spec;
+  for (int i = 0; i < num_species; i++) {
+    double colonization = num_species > 1 ? 0.2 + 0.6 * i / (num_species - 1) : 0.2;
+    spec.species.push_back({colonization, 0.1});
+  }
+  spec.SetHierarchy();
+  return spec;
+}
+
+/**
+ * @brief Run every timed operation of one case
+ */
+template <typename WORLD>
+void RunCase(WORLD &world, emp::Random &random, const BenchCase &bench,
+             const BenchOptions &options) {
+  const double cells = static_cast<double>(bench.size) * bench.size;
+  world.SetNeighborhood(NeighborhoodType::MOORE, false);
+  ApplyUpdateMode(world, options);
+  world.InitializeGrid(bench.size, bench.size);
+
+  {
+    BenchTimer timer(bench);
+    world.InitializeIncrementalDestruction(bench.destroyed, options.rounds,
+                                           bench.pattern);
+    timer.Report("InitializeIncrementalDestruction", 1, cells);
+  }
+  {
+    BenchTimer timer(bench);
+    PopulateWithBothSpecies(world, 0.5, random);
+    timer.Report("PopulateWithBothSpecies", 1, cells);
+  }
+  {
+    BenchTimer timer(bench);
+    size_t rounds = 0;
+    while (world.IsIncrementalDestructionActive()) {
+      world.ProcessIncrementalDestruction();
+      rounds++;
+    }
+    timer.Report("ProcessIncrementalDestruction", rounds, cells / std::max(1, options.rounds));
+  }
+  {
+    int updates = static_cast<int>(options.cell_updates / cells);
+    updates = std::max(1, std::min(updates, options.max_updates));
+    BenchTimer timer(bench);
+    for (int update = 0; update < updates; update++) {
+      world.UpdateEcology();
+    }
+    timer.Report("UpdateEcology", updates, cells);
+  }
+  BenchTryColonize(world, bench, 1000000);
+  {
+    size_t calls = std::max<size_t>(1, static_cast<size_t>(1e8 / cells));
+    calls = std::min<size_t>(calls, 1000);
+    BenchTimer timer(bench);
+    int checksum = 0;
+    for (size_t i = 0; i < calls; i++) {
+      checksum += world.CountCells()[0];
+    }
+    timer.Report("CountCells", calls, cells);
+    if (checksum == -1)
+      std::cerr << checksum; // keep the calls from being optimized away
+  }
+}
+
+/**
+ * @brief Parse command-line options
+ * @return False (after printing the problem) on a malformed option
+ */
+bool ParseOptions(int argc, char *argv[], BenchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << name << std::endl;
+      return false;
+    }
+    std::string value = argv[++i];
+    std::vector<double> values;
+    if (!ParseSweepAxis(value, values)) {
+      std::cerr << "Cannot parse " << name << " '" << value << "'" << std::endl;
+      return false;
+    }
+    if (name == "--engines")
+      options.engines = values;
+    else if (name == "--sizes")
+      options.sizes = values;
+    else if (name == "--destroyed")
+      options.destroyed = values;
+    else if (name == "--patterns")
+      options.patterns = values;
+    else if (name == "--rounds")
+      options.rounds = static_cast<int>(values[0]);
+    else if (name == "--cell-updates")
+      options.cell_updates = values[0];
+    else if (name == "--max-updates")
+      options.max_updates = static_cast<int>(values[0]);
+    else if (name == "--seed")
+      options.seed = static_cast<int>(values[0]);
+    else if (name == "--update-mode")
+      options.update_mode = static_cast<int>(values[0]);
+    else if (name == "--tile-size")
+      options.tile_size = static_cast<int>(values[0]);
+    else if (name == "--update-threads")
+      options.update_threads = static_cast<int>(values[0]);
+    else if (name == "--rng-mode")
+      options.rng_mode = static_cast<int>(values[0]);
+    else if (name == "--species")
+      options.species = std::max(1, std::min(static_cast<int>(values[0]),
+                                             static_cast<int>(CommunityWorld::MAX_SPECIES)));
+    else {
+      std::cerr << "Unknown option " << name << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  BenchOptions options;
+  if (!ParseOptions(argc, argv, options))
+    return 1;
+
+  std::printf("Engine,Width,Height,Destruction,Pattern,Operation,Calls,Seconds,"
+              "NsPerCall,NsPerCell,CallsPerSec,AllocsPerCall\n");
+  for (double engine : options.engines) {
+    for (double size : options.sizes) {
+      for (double destroyed : options.destroyed) {
+        for (double pattern : options.patterns) {
+          BenchCase bench = {static_cast<int>(engine), static_cast<int>(size),
+                             destroyed, static_cast<int>(pattern)};
+          std::cerr << "Engine " << bench.engine << ", " << bench.size << "x"
+                    << bench.size << ", destroyed " << destroyed << ", pattern "
+                    << bench.pattern << std::endl;
+
+          emp::Random random(options.seed);
+          if (bench.engine == 1) {
+            CompactWorld world(random);
+            RunCase(world, random, bench, options);
+          } else if (bench.engine == 2) {
+            GillespieWorld world(random);
+            RunCase(world, random, bench, options);
+          } else if (bench.engine == 3) {
+            CommunityWorld world(random);
+            world.SetCommunity(TradeOffCommunity(options.species));
+            RunCase(world, random, bench, options);
+          } else {
+            OrgWorld world(random);
+            RunCase(world, random, bench, options);
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
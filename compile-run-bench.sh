@@ -0,0 +1,2 @@
+g++ -O3 -DNDEBUG -march=native -Wall -Wno-unused-function -std=c++17 -pthread -Isignalgp-lite/third-party/Empirical/include/ -Isignalgp-lite/include/ benchmark.cpp -o benchmark_project
+./benchmark_project "$@" > benchmark_results.csv
\ No newline at end of file
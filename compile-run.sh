@@ -1,2 +1,3 @@
-g++ -O3 -DNDEBUG -march=native -Wall -Wno-unused-function -std=c++17 -Isignalgp-lite/third-party/Empirical/include/ -Isignalgp-lite/include/ native.cpp -o native_project
+g++ -O3 -DNDEBUG -march=native -Wall -Wno-unused-function -std=c++17 -pthread -Isignalgp-lite/third-party/Empirical/include/ -Isignalgp-lite/include/ native.cpp -o native_project
+g++ -O2 -Wall -std=c++17 timeseries_to_csv.cpp -o timeseries_to_csv
 ./native_project
\ No newline at end of file
@@ -1,89 +1,328 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include "emp/data/DataFile.hpp"
 
+#include "Checkpoint.h"
+#include "CommunityWorld.h"
+#include "CompactWorld.h"
+#include "GillespieWorld.h"
+#include "Landscape.h"
 #include "ConfigSetup.h"
 #include "Org.h"
+#include "Populate.h"
+#include "ReplicateStats.h"
 #include "SpeciesD.h"
 #include "SpeciesC.h"
+#include "StoppingRule.h"
+#include "SweepRunner.h"
+#include "SweepSpec.h"
+#include "TimeSeries.h"
 #include "World.h"
 
 /**
-  * @brief Add both species to occupy 25% each of available habitat
-  * 
-  * Based on the paper's specification that "each species occupies 0.25 
-  * of the remaining available habitat" at initialization.
-  */
-  void PopulateWithBothSpecies(OrgWorld &world, double initial_occupancy,
-     emp::Random &random_generator) {
-      // Clear existing organisms
-      for (size_t i = 0; i < world.GetSize(); i++) {
-         if (world.IsOccupied(i)) {
-             world.RemoveOrganism(i);
-         }
-      }
-      // Count available cells (non-destroyed habitat)
-      std::vector<size_t> available_cells;
-      for (size_t i = 0; i < world.GetSize(); i++) {
-        if (world.IsAvailable(i)) {
-            available_cells.push_back(i);
-          }
-   }     
-    // Calculate how many cells each species should occupy
-    // Each species gets 25% of available habitat
-    int cells_per_species = static_cast<int>(available_cells.size() * 0.25);
-     // Manually shuffle the available cells for random distribution
-     for (size_t i = available_cells.size() - 1; i > 0; i--) {
-          size_t j = random_generator.GetUInt(i + 1);
-          std::swap(available_cells[i], available_cells[j]);
-    }
-   // Add species C to first 25% of shuffled available cells
-     for (int i = 0; i < cells_per_species && i < available_cells.size(); i++) {
-            SpeciesC* new_organism = new SpeciesC(&random_generator);
-            world.AddOrgAt(new_organism, available_cells[i]);
-      }
-            
-   // Add species D to next 25% of shuffled available cells
-       for (int i = cells_per_species; 
-        i < cells_per_species * 2 && i < available_cells.size(); i++) {
-        SpeciesD* new_organism = new SpeciesD(&random_generator);
-        world.AddOrgAt(new_organism, available_cells[i]);
-    }
+ * @brief Apply the update-mode and RNG settings of the engines that have them
+ * @param seed Seed of the run, the key of the counter-based random numbers
+ */
+template <typename WORLD>
+void ApplyUpdateMode(WORLD &world, const SweepSpec &spec, uint64_t seed) {}
+
+void ApplyUpdateMode(OrgWorld &world, const SweepSpec &spec, uint64_t seed) {
+  world.SetRngMode(spec.rng_mode, seed);
+}
+
+/**
+ * @brief Get the calling sweep thread's pool for the parallel update modes
+ *
+ * Each sweep thread keeps one pool for all of its jobs, so runs do not
+ * start and join their update threads one by one.
+ */
+ThreadPool &GetUpdatePool(size_t threads) {
+  thread_local std::unique_ptr<ThreadPool> pool;
+  if (!pool || pool->GetNumThreads() != threads) {
+    pool = std::make_unique<ThreadPool>(threads);
+  }
+  return *pool;
+}
+
+void ApplyUpdateMode(CompactWorld &world, const SweepSpec &spec, uint64_t seed) {
+  world.SetUpdateMode(spec.update_mode, spec.tile_size, spec.update_threads);
+  if (spec.update_threads > 1) {
+    world.SetThreadPool(&GetUpdatePool(spec.update_threads));
+  }
+  world.SetRngMode(spec.rng_mode, seed);
+}
+
+void ApplyUpdateMode(CommunityWorld &world, const SweepSpec &spec, uint64_t seed) {
+  world.SetRngMode(spec.rng_mode, seed);
+}
+
+/**
+ * @brief Start a run from the shared checkpoint
+ *
+ * Takes the grid from the checkpoint but keeps this job's own random
+ * stream, so replicates diverge from the common starting point.  The event
+ * counters restart at 0, so they and the time series count only the events
+ * of this run, not those of the burn-in.
+ *
+ * @return False with error set if the checkpoint cannot be loaded
+ */
+template <typename WORLD>
+bool LoadWarmStart(WORLD &world, emp::Random &random,
+                   const std::vector<uint8_t> &warm_start, std::string &error) {
+  emp::Random job_random = random;
+  int burn_in_updates = 0;
+  if (!LoadCheckpoint(world, random, warm_start, burn_in_updates, error))
+    return false;
+  world.SetEventCounts(0, 0);
+  random = job_random;
+  return true;
+}
+
+/**
+ * @brief Checkpoints hold two species; SweepSpec rejects them with ENGINE 3
+ */
+bool LoadWarmStart(CommunityWorld &, emp::Random &, const std::vector<uint8_t> &,
+                   std::string &error) {
+  error = "ENGINE 3 cannot start from a checkpoint";
+  return false;
+}
+
+/**
+ * @brief Append the world's current state to a time series
+ */
+template <typename WORLD>
+void RecordSample(TimeSeriesRecorder &recorder, int update, WORLD &world) {
+  recorder.Record(update, world.GetDestructionSchedule().GetRound(), world.CountCells(),
+                  world.GetExtinctionEvents(), world.GetColonizationEvents());
+}
+
+/**
+ * @brief The .dyts format holds two species; SweepSpec rejects time series
+ *        with ENGINE 3
+ */
+void RecordSample(TimeSeriesRecorder &, int, CommunityWorld &) {}
+
+/**
+ * @brief Get the counts of every grid column, each in the order of CountCells
+ */
+template <typename WORLD>
+std::vector<std::vector<int>> CountColumns(const WORLD &world) {
+  std::vector<std::vector<int>> columns;
+  for (int col = 0; col < world.GetWidth(); col++) {
+    const auto counts = world.CountColumn(col);
+    columns.emplace_back(counts.begin(), counts.end());
+  }
+  return columns;
+}
+
+/**
+ * @brief Size a world's grid, on the habitat mask if there is one
+ */
+template <typename WORLD>
+void InitializeGrid(WORLD &world, const SweepSpec &spec) {
+  if (spec.habitat_mask) {
+    world.InitializeGrid(spec.habitat_mask);
+  } else {
+    world.InitializeGrid(spec.grid_width, spec.grid_height);
+  }
+}
+
+/**
+ * @brief Set up a run's habitat destruction
+ * @param landscape If not null, a shared landscape used instead of drawing
+ *        one from the world's generator
+ */
+template <typename WORLD>
+void InitializeDestruction(WORLD &world, const SweepPoint &point,
+                           const emp::vector<size_t> *landscape) {
+  if (landscape) {
+    world.InitializeIncrementalDestruction(*landscape, point.rounds);
+  } else {
+    world.InitializeIncrementalDestruction(point.percent_destroyed, point.rounds,
+                                           point.pattern);
   }
+}
+
 /**
- * @brief Helper function that adds species D to random available positions
+ * @brief Run one incremental-destruction experiment on a world engine
+ * @param world OrgWorld, CompactWorld, GillespieWorld or CommunityWorld to run on
+ * @param random Random number generator shared with the world
+ * @param spec Sweep settings (grid size, neighbourhood, updates, initial occupancy)
+ * @param point Destruction parameters of this run
+ * @param recorder If not null, receives the run's time series
+ * @param warm_start If not null, a checkpoint to start from instead of a
+ *        freshly populated grid; destruction starts after it is loaded
+ * @param landscape If not null, the run's destruction landscape (LANDSCAPE_SEED)
+ * @param stop_update If not null, set to the number of updates run
+ * @param error If not null, set to the reason when the warm start cannot
+ *        be loaded
+ * @return Final counts: one per species ([species_c, species_d] for the
+ *         two-species engines), then empty and destroyed; empty if the
+ *         warm start cannot be loaded
+ *
+ * With spec.stopping rules, the run ends at the first update after which a
+ * rule holds.  If every species is extinct by then, the remaining
+ * destruction rounds are still applied, so the final counts equal those of
+ * the full run.
  */
-void PopulateWithSpeciesD(OrgWorld &world, double initial_occupancy,
-                          emp::Random &random_generator) {
-  // Clear existing organisms
-  for (size_t i = 0; i < world.GetSize(); i++) {
-    if (world.IsOccupied(i)) {
-      world.RemoveOrganism(i);
+template <typename WORLD>
+std::vector<int> RunExperiment(WORLD &world, emp::Random &random,
+                                 const SweepSpec &spec, const SweepPoint &point,
+                                 TimeSeriesRecorder *recorder = nullptr,
+                                 const std::vector<uint8_t> *warm_start = nullptr,
+                                 const emp::vector<size_t> *landscape = nullptr,
+                                 int *stop_update = nullptr,
+                                 std::string *error = nullptr) {
+  ApplyUpdateMode(world, spec, random.GetSeed());
+  if (warm_start) {
+    std::string load_error;
+    if (!LoadWarmStart(world, random, *warm_start, load_error)) {
+      if (error)
+        *error = load_error;
+      return {};
     }
+    world.SetHabitatMask(spec.habitat_mask);
+    InitializeDestruction(world, point, landscape);
+  } else {
+    // Initialize the world grid
+    world.SetNeighborhood(spec.neighborhood, spec.wrap_edges);
+    InitializeGrid(world, spec);
+    // Initialize incremental destruction
+    InitializeDestruction(world, point, landscape);
+
+    // Populate with species before destruction starts
+    PopulateWithBothSpecies(world, spec.initial_occupancy, random);
   }
-  // Count available cells
-  std::vector<size_t> available_cells;
-  for (size_t i = 0; i < world.GetSize(); i++) {
-    if (world.IsAvailable(i)) {
-      available_cells.push_back(i);
+
+  auto record = [&](int update) {
+    if (recorder && recorder->IsDue(update, spec.updates)) {
+      RecordSample(*recorder, update, world);
+    }
+  };
+  record(0);
+
+  // Process destruction and ecology updates together
+  StoppingRule stopping(spec.stopping);
+  int updates_run = spec.updates;
+  for (int update = 0; update < spec.updates; update++) {
+    // Process incremental destruction if active
+    if (world.IsIncrementalDestructionActive()) {
+      world.ProcessIncrementalDestruction();
+    }
+    world.UpdateEcology();
+    record(update + 1);
+
+    if (!stopping.IsEnabled())
+      continue;
+    const auto counts = world.CountCells();
+    const size_t num_species = counts.size() - 2;
+    if (!stopping.Check(counts, num_species, world.IsIncrementalDestructionActive()))
+      continue;
+    updates_run = update + 1;
+    if (recorder && !recorder->IsDue(updates_run, spec.updates)) {
+      RecordSample(*recorder, updates_run, world);
+    }
+    // Nothing can recolonize: only the pending destruction changes the counts
+    if (StoppingRule::IsAbsorbing(counts, num_species)) {
+      for (int rest = updates_run; rest < spec.updates; rest++) {
+        if (!world.IsIncrementalDestructionActive())
+          break;
+        world.ProcessIncrementalDestruction();
+      }
     }
+    break;
   }
-  // Populate initial_occupancy fraction of available cells
-  int target_organisms =
-      static_cast<int>(available_cells.size() * initial_occupancy);
+  if (stop_update)
+    *stop_update = updates_run;
+
+  const auto counts = world.CountCells();
+  return std::vector<int>(counts.begin(), counts.end());
+}
 
-  // Manually shuffle the available cells
-  for (size_t i = available_cells.size() - 1; i > 0; i--) {
-    size_t j = random_generator.GetUInt(i + 1);
-    std::swap(available_cells[i], available_cells[j]);
+/**
+ * @brief Populate an intact grid and let it settle before destruction
+ * @param world OrgWorld, CompactWorld or GillespieWorld to run on
+ * @param random Random number generator shared with the world
+ * @param spec Sweep settings (grid size, neighbourhood, initial occupancy)
+ * @param burn_in Number of ecology updates to run
+ * @return Checkpoint of the settled world
+ */
+template <typename WORLD>
+std::vector<uint8_t> RunBurnIn(WORLD &world, emp::Random &random,
+                               const SweepSpec &spec, int burn_in) {
+  ApplyUpdateMode(world, spec, random.GetSeed());
+  world.SetNeighborhood(spec.neighborhood, spec.wrap_edges);
+  InitializeGrid(world, spec);
+  PopulateWithBothSpecies(world, spec.initial_occupancy, random);
+  for (int update = 0; update < burn_in; update++) {
+    world.UpdateEcology();
   }
+  return SaveCheckpoint(world, random, burn_in);
+}
 
-  for (int i = 0; i < target_organisms && i < available_cells.size(); i++) {
-    emp::Ptr<SpeciesD> new_organism = new SpeciesD(&random_generator);
-    world.AddOrgAt(new_organism, available_cells[i]);
+/**
+ * @brief Build or load the checkpoint every job of the sweep starts from
+ * @param config Loaded configuration
+ * @param spec Sweep settings
+ * @param warm_start Set to the checkpoint; left empty if jobs start fresh
+ * @param error Set to a description of the problem on failure
+ * @return False if the checkpoint cannot be loaded, saved or does not match
+ *
+ * LOAD_CHECKPOINT takes precedence over BURN_IN.  A burn-in runs once with
+ * SEED, and is saved to SAVE_CHECKPOINT if that is set.
+ */
+bool PrepareWarmStart(const MyConfigType &config, const SweepSpec &spec,
+                      std::vector<uint8_t> &warm_start, std::string &error) {
+  warm_start.clear();
+  const std::string load_path = config.LOAD_CHECKPOINT();
+  const std::string save_path = config.SAVE_CHECKPOINT();
+
+  emp::Random random(config.SEED());
+  CompactWorld probe(random);
+  if (!load_path.empty()) {
+    if (!ReadFileBytes(load_path, warm_start)) {
+      error = "Cannot read " + load_path;
+      return false;
+    }
+    int update = 0;
+    if (!LoadCheckpoint(probe, random, warm_start, update, error)) {
+      error = load_path + ": " + error;
+      return false;
+    }
+    if (probe.GetWidth() != spec.grid_width || probe.GetHeight() != spec.grid_height ||
+        probe.GetNeighborhoodType() != spec.neighborhood ||
+        probe.GetWrapEdges() != spec.wrap_edges) {
+      error = load_path + " does not match the grid and neighbourhood settings";
+      return false;
+    }
+    std::cout << "Starting every run from " << load_path << " (update " << update
+              << ")" << std::endl;
+  } else if (config.BURN_IN() > 0) {
+    if (config.ENGINE() == 1) {
+      warm_start = RunBurnIn(probe, random, spec, config.BURN_IN());
+    } else if (config.ENGINE() == 2) {
+      GillespieWorld world(random);
+      warm_start = RunBurnIn(world, random, spec, config.BURN_IN());
+    } else {
+      OrgWorld world(random);
+      warm_start = RunBurnIn(world, random, spec, config.BURN_IN());
+    }
+    std::cout << "Burn-in of " << config.BURN_IN() << " updates done" << std::endl;
+  }
+
+  if (!save_path.empty() && !warm_start.empty()) {
+    if (!WriteFileBytes(save_path, warm_start)) {
+      error = "Cannot write " + save_path;
+      return false;
+    }
+    std::cout << "Checkpoint saved to " << save_path << std::endl;
   }
+  return true;
 }
 
 
@@ -94,113 +333,307 @@ int main(int argc, char *argv[]) {
   if (!success)
     config.Write("MySettings.cfg");
 
-  // Create data file for recording results
-  emp::Random random(config.SEED());
-  OrgWorld world(random);
-  double initial_occupancy = 0.5;
+  // Expand the configured sweep into a job list
+  SweepSpec spec;
+  std::string error;
+  if (!spec.Configure(config, error)) {
+    std::cerr << "Invalid sweep settings: " << error << std::endl;
+    return 1;
+  }
+
+  // Optional shared starting state (burn-in or loaded checkpoint)
+  std::vector<uint8_t> warm_start;
+  if (!PrepareWarmStart(config, spec, warm_start, error)) {
+    std::cerr << "Checkpoint error: " << error << std::endl;
+    return 1;
+  }
+  const std::vector<uint8_t> *warm_start_ptr =
+      warm_start.empty() ? nullptr : &warm_start;
 
-  // Create CSV file with unique name
+  // Create CSV file with unique name (neither it nor its summaries may exist)
+  auto name_taken = [](const std::string &name) {
+    const std::string stem = name.substr(0, name.size() - 4);
+    return std::ifstream(name).good() || std::ifstream(stem + "_summary.csv").good() ||
+           std::ifstream(stem + "_columns.csv").good();
+  };
   std::string filename = "experiment_results.csv";
   int file_number = 1;
-  std::ifstream test_file(filename);
-  while (test_file.good()) {
-    test_file.close();
+  while (name_taken(filename)) {
     filename = "experiment_results_" + std::to_string(file_number) + ".csv";
-    test_file.open(filename);
     file_number++;
   }
-  test_file.close();
-  
-  // //For expriment results
-  // std::ofstream outputfile(filename);
-  // outputfile << "Destruction,Species_C,Species_D,Empty,Destroyed\n";
-  // // Loop through different destruction percentages
-  // for (double destruction = 0.25; destruction < 0.76; destruction += 0.01) {
-  //   // Initialize the world grid
-  //   world.InitializeGrid(50, 50);
-
-  //   // Set destruction
-  //   if (config.DESTRUCTION_ROUNDS() > 0) {
-  //     // Initialize incremental destruction
-  //     world.InitializeIncrementalDestruction(destruction, config.DESTRUCTION_ROUNDS(), config.DESTRUCTION_PATTERN());
-      
-  //     // Populate with species before destruction starts
-  //     PopulateWithBothSpecies(world, initial_occupancy, random);
-      
-  //     // Process destruction and ecology updates together
-  //     for (int update = 0; update < 1000; update++) {
-  //       // Process incremental destruction if active
-  //       if (world.IsIncrementalDestructionActive()) {
-  //         world.ProcessIncrementalDestruction();
-  //       }
-  //       world.UpdateEcology();
-  //     }
-  //   } else {
-  //     // Original immediate destruction
-  //     if (config.DESTRUCTION_PATTERN() == 0) {
-  //       world.DestroyHabitatRandom(destruction);
-  //     } else {
-  //       world.DestroyHabitatGradient(destruction);
-  //     }
-      
-  //     PopulateWithBothSpecies(world, initial_occupancy, random);
-      
-  //     // Run simulation for 1000 updates
-  //     for (int update = 0; update < 1000; update++) {
-  //       world.UpdateEcology();
-  //     }
-  //   }
-    
-  //   // create a array that gets count using CountCells from world and print
-  //   // coutcells
-  //   emp::array<int, 4> counts = world.CountCells(); // doesn't like this line for some reason but still works.
-    
-  //   std::cout << "Destruction: " << destruction << ", Species C: " << counts[0]
-  //             << ", Species D: " << counts[1] << ", Empty: " << counts[2]
-  //             << ", Destroyed: " << counts[3] << std::endl;
-    
-  //   // Write same data to CSV
-  //   outputfile << destruction << "," << counts[0] << "," << counts[1] << "," 
-  //              << counts[2] << "," << counts[3] << "\n";
-  // }
-  
+
   //For expriment results
-  std::ofstream outputfile(filename);
-  outputfile << "Rounds,Species_C,Species_D,Empty,Destroyed\n";
-  // Loop through different destruction percentages
-  for (int rounds = 0; rounds <= 100; rounds++) {
-    // Initialize the world grid
-    world.InitializeGrid(50, 50);
-      // Initialize incremental destruction
-      world.InitializeIncrementalDestruction(0.5, rounds, 0);
-      
-      // Populate with species before destruction starts
-      PopulateWithBothSpecies(world, initial_occupancy, random);
-      
-      // Process destruction and ecology updates together
-      for (int update = 0; update < 1000; update++) {
-        // Process incremental destruction if active
-        if (world.IsIncrementalDestructionActive()) {
-          world.ProcessIncrementalDestruction();
+  const int engine = config.ENGINE();
+  const size_t num_species = engine == 3 ? spec.community.GetNumSpecies() : 2;
+  std::vector<std::string> species_names = {"Species_C", "Species_D"};
+  if (engine == 3) {
+    species_names.clear();
+    for (size_t species = 0; species < num_species; species++) {
+      species_names.push_back("Species_" + std::to_string(species));
+    }
+  }
+  const bool write_runs = spec.replicate_summary != 2;
+  const bool stop_columns = spec.stopping.IsEnabled();
+  std::ofstream outputfile;
+  if (write_runs) {
+    outputfile.open(filename);
+    outputfile << "Pattern,Destruction,Rounds,Replicate,Seed,";
+    for (const std::string &name : species_names) {
+      outputfile << name << ",";
+    }
+    outputfile << "Empty,Destroyed" << (stop_columns ? ",Stop_Update\n" : "\n");
+  }
+
+  // Optional replicate statistics, one row per parameter point
+  const std::string summary_filename =
+      filename.substr(0, filename.size() - 4) + "_summary.csv";
+  std::ofstream summary_file;
+  ReplicateSummary summary(species_names);
+  RunningStats stop_updates;
+  if (spec.replicate_summary > 0) {
+    summary_file.open(summary_filename);
+    summary_file << "Pattern,Destruction,Rounds,";
+    summary.WriteHeader(summary_file);
+    summary_file << (stop_columns ? ",Stop_Update_Mean\n" : "\n");
+  }
+
+  // Optional final counts per grid column, one row per run and column
+  const bool column_counts = config.COLUMN_COUNTS() != 0;
+  const std::string columns_filename =
+      filename.substr(0, filename.size() - 4) + "_columns.csv";
+  std::ofstream columns_file;
+  if (column_counts) {
+    columns_file.open(columns_filename);
+    columns_file << "Pattern,Destruction,Rounds,Replicate,Seed,Column,";
+    for (const std::string &name : species_names) {
+      columns_file << name << ",";
+    }
+    columns_file << "Empty,Destroyed\n";
+  }
+
+  // Optional per-update trajectories, next to the CSV with a .dyts extension
+  const int timeseries_interval = config.TIMESERIES_INTERVAL();
+  std::unique_ptr<TimeSeriesWriter> timeseries;
+  if (timeseries_interval > 0) {
+    std::string timeseries_filename =
+        filename.substr(0, filename.size() - 4) + ".dyts";
+    timeseries = std::make_unique<TimeSeriesWriter>(
+        timeseries_filename, config.TIMESERIES_COMPRESS() != 0);
+    if (!timeseries->IsOpen()) {
+      std::cerr << "Cannot create " << timeseries_filename << std::endl;
+      return 1;
+    }
+    std::cout << "Writing time series to " << timeseries_filename << std::endl;
+  }
+
+  // Every job gets its own world and a seed derived from SEED, its point in
+  // the full sweep and its replicate, so results do not depend on the number
+  // of threads or on how the sweep is sharded
+  const int base_seed = config.SEED();
+  SweepRunner runner(spec.sweep_threads);
+
+  // With LANDSCAPE_SEED, a landscape depends only on its pattern, fraction
+  // and replicate and is shared by every rounds value.  Jobs run point by
+  // point, so holding one landscape per replicate and worker keeps the hits.
+  std::unique_ptr<LandscapeCache> landscapes;
+  if (spec.landscape_seed >= 0) {
+    landscapes = std::make_unique<LandscapeCache>(spec.replicates +
+                                                  runner.GetNumThreads());
+  }
+
+  struct JobResult {
+    int seed = 0;
+    int stop_update = 0;     ///< Updates run, fewer if a stopping rule ended the run
+    std::vector<int> counts; ///< Per species, then empty and destroyed
+    std::vector<std::vector<int>> columns; ///< Counts per grid column, if COLUMN_COUNTS
+    std::vector<uint8_t> timeseries; ///< Encoded run block, if recording
+    std::string error;       ///< Why the run could not start, if it failed
+  };
+
+  // A job that cannot load the warm start stops the sweep; jobs not yet
+  // started then return at once
+  std::atomic<bool> failed(false);
+  std::string job_error;
+
+  runner.Run<JobResult>(
+      spec.GetNumJobs(),
+      [&](size_t job_id) {
+        SweepJob job = spec.GetJob(job_id);
+
+        JobResult result;
+        if (failed)
+          return result;
+        result.seed = DeriveSeed(base_seed, job.point_id, job.replicate);
+        emp::Random random(result.seed);
+        LandscapeCache::Landscape landscape;
+        if (landscapes) {
+          landscape = landscapes->Get(job.point.pattern, job.point.percent_destroyed,
+                                      spec.grid_width, spec.grid_height,
+                                      DeriveSeed(spec.landscape_seed, 0, job.replicate),
+                                      spec.habitat_mask.get());
+        }
+        std::unique_ptr<TimeSeriesRecorder> recorder;
+        if (timeseries) {
+          recorder = std::make_unique<TimeSeriesRecorder>(timeseries_interval,
+                                                          spec.updates);
+        }
+        if (engine == 1) {
+          CompactWorld world(random);
+          result.counts = RunExperiment(world, random, spec, job.point,
+                                        recorder.get(), warm_start_ptr,
+                                        landscape.get(), &result.stop_update,
+                                        &result.error);
+          if (column_counts)
+            result.columns = CountColumns(world);
+        } else if (engine == 3) {
+          CommunityWorld world(random);
+          world.SetCommunity(spec.community);
+          result.counts = RunExperiment(world, random, spec, job.point,
+                                        recorder.get(), warm_start_ptr,
+                                        landscape.get(), &result.stop_update,
+                                        &result.error);
+          if (column_counts)
+            result.columns = CountColumns(world);
+        } else if (engine == 2) {
+          GillespieWorld world(random);
+          result.counts = RunExperiment(world, random, spec, job.point,
+                                        recorder.get(), warm_start_ptr,
+                                        landscape.get(), &result.stop_update,
+                                        &result.error);
+          if (column_counts)
+            result.columns = CountColumns(world);
+        } else {
+          OrgWorld world(random);
+          result.counts = RunExperiment(world, random, spec, job.point,
+                                        recorder.get(), warm_start_ptr,
+                                        landscape.get(), &result.stop_update,
+                                        &result.error);
+          if (column_counts)
+            result.columns = CountColumns(world);
+        }
+        if (!result.error.empty()) {
+          failed = true;
+          return result;
+        }
+        if (recorder) {
+          TimeSeriesRunInfo info;
+          info.pattern = job.point.pattern;
+          info.percent_destroyed = job.point.percent_destroyed;
+          info.rounds = job.point.rounds;
+          info.replicate = static_cast<uint32_t>(job.replicate);
+          info.seed = result.seed;
+          result.timeseries = recorder->Encode(info, timeseries->IsCompressed());
+        }
+        return result;
+      },
+      [&](size_t job_id, const JobResult &result) {
+        if (failed) {
+          if (!result.error.empty() && job_error.empty()) {
+            job_error = result.error;
+            std::cerr << "Checkpoint error: " << job_error << std::endl;
+          }
+          return;
+        }
+        SweepJob job = spec.GetJob(job_id);
+        const std::vector<int> &counts = result.counts;
+
+        if (write_runs) {
+          std::cout << "Pattern: " << job.point.pattern
+                    << ", Destruction: " << job.point.percent_destroyed
+                    << ", Rounds: " << job.point.rounds
+                    << ", Replicate: " << job.replicate;
+          if (engine == 3) {
+            for (size_t species = 0; species < num_species; species++) {
+              std::cout << ", Species " << species << ": " << counts[species];
+            }
+          } else {
+            std::cout << ", Species C: " << counts[0] << ", Species D: " << counts[1];
+          }
+          std::cout << ", Empty: " << counts[num_species]
+                    << ", Destroyed: " << counts[num_species + 1];
+          if (stop_columns) {
+            std::cout << ", Stopped at: " << result.stop_update;
+          }
+          std::cout << std::endl;
+
+          // Write same data to CSV
+          outputfile << job.point.pattern << "," << job.point.percent_destroyed
+                     << "," << job.point.rounds << "," << job.replicate << ","
+                     << result.seed;
+          for (int count : counts) {
+            outputfile << "," << count;
+          }
+          if (stop_columns) {
+            outputfile << "," << result.stop_update;
+          }
+          outputfile << "\n";
         }
-        world.UpdateEcology();
-      }
-    
-    // create a array that gets count using CountCells from world and print
-    // coutcells
-    emp::array<int, 4> counts = world.CountCells(); // doesn't like this line for some reason but still works.
-    
-    std::cout << "Rounds: " << rounds << ", Species C: " << counts[0]
-              << ", Species D: " << counts[1] << ", Empty: " << counts[2]
-              << ", Destroyed: " << counts[3] << std::endl;
-    
-    // Write same data to CSV
-    outputfile << rounds << "," << counts[0] << "," << counts[1] << "," 
-               << counts[2] << "," << counts[3] << "\n";
-  }
-  
-  outputfile.close();
-  std::cout << "Results saved to " << filename << std::endl;
+
+        // Replicates of a point arrive together; write its row after the last
+        if (spec.replicate_summary > 0) {
+          summary.Add(counts);
+          stop_updates.Add(result.stop_update);
+          if (job.replicate + 1 == spec.replicates) {
+            summary_file << job.point.pattern << "," << job.point.percent_destroyed
+                         << "," << job.point.rounds << ",";
+            summary.WriteRow(summary_file);
+            if (stop_columns) {
+              summary_file << "," << stop_updates.GetMean();
+            }
+            summary_file << "\n";
+            if (!write_runs) {
+              std::cout << "Pattern: " << job.point.pattern
+                        << ", Destruction: " << job.point.percent_destroyed
+                        << ", Rounds: " << job.point.rounds
+                        << ", Replicates: " << summary.GetReplicates();
+              for (size_t species = 0; species < num_species; species++) {
+                std::cout << ", " << species_names[species] << " mean: "
+                          << summary.GetSpecies(species).GetStats().GetMean();
+              }
+              std::cout << ", Coexisting: " << summary.GetCoexisting() << std::endl;
+            }
+            summary.Reset();
+            stop_updates = RunningStats();
+          }
+        }
+
+        if (column_counts) {
+          for (size_t col = 0; col < result.columns.size(); col++) {
+            columns_file << job.point.pattern << "," << job.point.percent_destroyed << ","
+                         << job.point.rounds << "," << job.replicate << "," << result.seed
+                         << "," << col;
+            for (int count : result.columns[col]) {
+              columns_file << "," << count;
+            }
+            columns_file << "\n";
+          }
+        }
+
+        if (timeseries) {
+          timeseries->WriteBlock(result.timeseries);
+        }
+      });
+
+  if (failed) {
+    return 1;
+  }
+  if (landscapes) {
+    std::cout << "Landscapes generated: " << landscapes->GetMisses()
+              << ", reused: " << landscapes->GetHits() << std::endl;
+  }
+  if (write_runs) {
+    outputfile.close();
+    std::cout << "Results saved to " << filename << std::endl;
+  }
+  if (spec.replicate_summary > 0) {
+    summary_file.close();
+    std::cout << "Replicate summaries saved to " << summary_filename << std::endl;
+  }
+  if (column_counts) {
+    columns_file.close();
+    std::cout << "Column counts saved to " << columns_filename << std::endl;
+  }
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TimeSeries.h"
+
+/**
+ * @brief Convert a .dyts time-series file written by native_project to CSV
+ *
+ * Usage: timeseries_to_csv input.dyts [output.csv]
+ * Writes one row per sample, prefixed with the run's parameters; without an
+ * output path the CSV goes to standard output.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " input.dyts [output.csv]" << std::endl;
+    return 1;
+  }
+
+  TimeSeriesReader reader;
+  std::string error;
+  if (!reader.Open(argv[1], error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  FILE *out = stdout;
+  if (argc == 3) {
+    out = std::fopen(argv[2], "w");
+    if (!out) {
+      std::cerr << "Cannot create " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+
+  std::fputs("Pattern,Destruction,Rounds,Replicate,Seed", out);
+  for (const std::string &name : reader.GetColumnNames()) {
+    std::fprintf(out, ",%s", name.c_str());
+  }
+  std::fputc('\n', out);
+
+  TimeSeriesRunInfo info;
+  std::vector<std::vector<int32_t>> columns;
+  size_t num_runs = 0;
+  while (reader.ReadRun(info, columns)) {
+    size_t num_samples = columns.empty() ? 0 : columns[0].size();
+    for (size_t i = 0; i < num_samples; i++) {
+      std::fprintf(out, "%d,%g,%d,%u,%d", info.pattern, info.percent_destroyed,
+                   info.rounds, info.replicate, info.seed);
+      for (const std::vector<int32_t> &column : columns) {
+        std::fprintf(out, ",%d", column[i]);
+      }
+      std::fputc('\n', out);
+    }
+    num_runs++;
+  }
+
+  if (out != stdout)
+    std::fclose(out);
+
+  if (!reader.AtEnd()) {
+    std::cerr << "Truncated run after " << num_runs << " complete runs" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -9,7 +9,15 @@
 #include "emp/prefab/ConfigPanel.hpp"
 #include "emp/web/UrlParams.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <emscripten.h>
+#include <string>
+
+#include "CellImage.h"
 #include "ConfigSetup.h"
+#include "Landscape.h"
 #include "Org.h"
 #include "SpeciesC.h"
 #include "SpeciesD.h"
@@ -27,28 +35,25 @@ MyConfigType config;
  */
 class Animator : public emp::web::Animate {
 private:
-  // Arena dimensions - 50x50 grid as specified in the paper
-  static constexpr int NUM_H_BOXES = 50;  ///< Grid height in cells
-  static constexpr int NUM_W_BOXES = 50;  ///< Grid width in cells
-  static constexpr double RECT_SIDE = 10; ///< Size of each cell in pixels
-  static constexpr double WIDTH = NUM_W_BOXES * RECT_SIDE;  ///< Canvas width
-  static constexpr double HEIGHT = NUM_H_BOXES * RECT_SIDE; ///< Canvas height
+  // Arena dimensions - GRID_WIDTH x GRID_HEIGHT, 50x50 as in the paper by default
+  static constexpr double MAX_RECT_SIDE = 10; ///< Largest size of a cell in pixels
+  static constexpr double VIEW_SIZE = 500;    ///< Longest canvas side for large grids
+  static constexpr double GRID_LINE_SIDE = 4; ///< Smallest cell size drawn with outlines
+  int num_w_boxes = 50;  ///< Grid width in cells
+  int num_h_boxes = 50;  ///< Grid height in cells
+  double rect_side = 10; ///< Size of each cell in pixels
 
   emp::web::Canvas canvas; ///< Canvas for rendering the simulation
   emp::Random *random;     ///< Random number generator
   OrgWorld *world;         ///< The ecosystem world
 
   // UI elements
-  emp::web::Div stats_div; ///< Div for displaying statistics
-
-  // Visualization colors
-  const std::string empty_color =
-      "green"; ///< Color for empty available habitat
-  const std::string destroyed_color = "black"; ///< Color for destroyed habitat
-  const std::string species_c_color =
-      "blue"; ///< Color for species C (superior competitor)
-  const std::string species_d_color =
-      "orange"; ///< Color for species D (superior disperser)
+  emp::web::Div stats_div;       ///< Div for displaying statistics
+  emp::web::Button run_to_button; ///< Labelled with the target of the last click
+
+  // One pixel per cell, coloured green (empty), black (destroyed), blue
+  // (species C) and orange (species D), scaled onto the canvas
+  CellImage image;
       
   // Track if we've initialized incremental destruction
   bool destruction_initialized = false;
@@ -56,11 +61,20 @@ private:
   // Round counter
   int round_count = 0;
 
+  // Fast-forward target of the "Run to update" button (0 = none)
+  int run_to_update = 0;
+
+  // Values on display, so stats_div is rebuilt only when they change
+  int shown_round = -1;
+  std::array<int, 4> shown_counts = {-1, -1, -1, -1};
+
 public:
   /**
    * @brief Construct the animator and set up the simulation
    */
-  Animator() : canvas(WIDTH, HEIGHT, "canvas"), stats_div("stats") {
+  Animator()
+      : canvas(VIEW_SIZE, VIEW_SIZE, "canvas"), stats_div("stats"),
+        run_to_button([this]() { StartRunTo(); }, "Run to update") {
     InitializeConfiguration();
     SetupInterface();
     InitializeSimulation();
@@ -68,24 +82,75 @@ public:
 
   /**
    * @brief Process one frame of the simulation
+   *
+   * Runs UPDATES_PER_FRAME updates, or while fast-forwarding as many as
+   * needed to reach the target, but stops once FRAME_BUDGET_MS have passed
+   * so the page stays responsive.  The grid and the statistics are drawn
+   * once per frame, after the updates.
    */
   void DoFrame() override {
-    canvas.Clear();
-    
+    const bool fast_forward = run_to_update > round_count;
+    const int updates = fast_forward ? run_to_update - round_count
+                                     : std::max(1, config.UPDATES_PER_FRAME());
+    const double start = emscripten_get_now();
+    for (int update = 0; update < updates; update++) {
+      StepSimulation();
+      if (emscripten_get_now() - start >= config.FRAME_BUDGET_MS())
+        break;
+    }
+    DrawWorld();
+    UpdateStats();
+
+    // Pause at the fast-forward target
+    if (fast_forward && round_count >= run_to_update) {
+      run_to_update = 0;
+      if (GetActive())
+        ToggleActive();
+    }
+  }
+
+private:
+  /**
+   * @brief Advance the simulation by one update
+   */
+  void StepSimulation() {
     // Process incremental destruction if active
     if (destruction_initialized && world->IsIncrementalDestructionActive()) {
       world->ProcessIncrementalDestruction();
     }
     
     world->UpdateEcology();
-    DrawWorld();
-    UpdateStats();
     
     // Increment round counter
     round_count++;
   }
 
-private:
+  /**
+   * @brief Advance exactly one update while paused (the Step button)
+   */
+  void StepOnce() {
+    if (GetActive())
+      return;
+    StepSimulation();
+    DrawWorld();
+    UpdateStats();
+  }
+
+  /**
+   * @brief Fast-forward to RUN_TO_UPDATE and pause there
+   *
+   * The target is read when the button is clicked, so it follows the
+   * slider, and the button is relabelled with it.
+   */
+  void StartRunTo() {
+    run_to_button.SetLabel("Run to update " + std::to_string(config.RUN_TO_UPDATE()));
+    if (config.RUN_TO_UPDATE() <= round_count)
+      return;
+    run_to_update = config.RUN_TO_UPDATE();
+    if (!GetActive())
+      ToggleActive();
+  }
+
   /**
    * @brief Initialize configuration from URL parameters
    */
@@ -100,6 +165,13 @@ private:
     random = new emp::Random(config.SEED());
     world = new OrgWorld(*random);
 
+    // Size the grid and the canvas; large grids shrink to VIEW_SIZE pixels
+    num_w_boxes = std::max(1, config.GRID_WIDTH());
+    num_h_boxes = std::max(1, config.GRID_HEIGHT());
+    rect_side = std::min(MAX_RECT_SIDE, VIEW_SIZE / std::max(num_w_boxes, num_h_boxes));
+    canvas.SetSize(num_w_boxes * rect_side, num_h_boxes * rect_side);
+    image.Resize(num_w_boxes, num_h_boxes);
+
     // Add configuration panel
     emp::prefab::ConfigPanel config_panel(config);
 
@@ -107,17 +179,27 @@ private:
     config_panel.SetRange("SEED", "1", "100", "1"); // Seed range 1-100
     config_panel.SetRange("PERCENT_DESTROYED", "0.25", "0.75",
                           "0.01"); // Destruction 25%-75%
-    config_panel.SetRange("DESTRUCTION_PATTERN", "0", "1",
-                          "1"); // Pattern: 0=Random, 1=Gradient
+    config_panel.SetRange("DESTRUCTION_PATTERN", "0", "3",
+                          "1"); // Pattern: 0=Random ... 3=Percolation
     config_panel.SetRange("DESTRUCTION_ROUNDS", "0", "100",
                           "1"); // Destruction rounds 0-100
+    config_panel.SetRange("NEIGHBORHOOD", "0", "1",
+                          "1"); // 0=Moore, 1=von Neumann
+    config_panel.SetRange("WRAP_EDGES", "0", "1",
+                          "1"); // 0=hard boundaries, 1=wrap
+    config_panel.SetRange("GRID_WIDTH", "10", "1000", "10"); // Grid width in cells
+    config_panel.SetRange("GRID_HEIGHT", "10", "1000", "10"); // Grid height in cells
+    config_panel.SetRange("UPDATES_PER_FRAME", "1", "100", "1"); // Fast-forward speed
+    config_panel.SetRange("RUN_TO_UPDATE", "0", "5000", "100"); // Fast-forward target
     
     settings << "<h3>How to interact with the simulation:</h3>";
     settings << "<ul>";
     settings << "<li>Use the sliders to adjust parameters!</li>";
     settings << "<li>Seed give random start</li>";
-    settings << "<li>Destruction pattern: 0 = Random, 1 = Gradient </li>";
+    settings << "<li>Destruction pattern: 0 = Random, 1 = Gradient, 2 = Clumped, 3 = Percolation </li>";
     settings << "<li>(<em>Expansion</em>) Destruction rounds: 0 = Immediate, 1-100 = Incremental over rounds</li>";
+    settings << "<li>Neighborhood: 0 = Moore (8 cells), 1 = von Neumann (4 cells); Wrap edges: 0 = hard boundaries, 1 = torus</li>";
+    settings << "<li>Updates per frame above 1 fast-forward; Run to update jumps to RUN_TO_UPDATE and pauses</li>";
     settings << "</ul>";
     settings << config_panel;
     settings << "<br>";
@@ -148,14 +230,18 @@ private:
     doc << "</ul>";
     doc << "<p>Both species have extinction rate = 0.1. Species C can invade "
            "cells occupied by Species D.</p>";
-    doc << "<p>Initially, 50% of available habitat is populated evenly by both "
-           "species.</p>";
+    doc << "<p>Initially, "
+        << static_cast<int>(std::lround(config.INITIAL_OCCUPANCY() * 100))
+        << "% of available habitat is populated evenly by both species.</p>";
 
     // Control buttons
     doc << "<div>";
     doc << GetToggleButton("Toggle");
     doc << " ";
-    doc << GetStepButton("Step");
+    doc << emp::web::Button([this]() { StepOnce(); }, "Step");
+    doc << " ";
+    run_to_button.SetLabel("Run to update " + std::to_string(config.RUN_TO_UPDATE()));
+    doc << run_to_button;
     doc << "</div>";
 
     doc << "<br>";
@@ -168,7 +254,11 @@ private:
    */
   void InitializeSimulation() {
     // Initialize grid
-    world->InitializeGrid(NUM_W_BOXES, NUM_H_BOXES);
+    world->SetNeighborhood(config.NEIGHBORHOOD() == 1
+                               ? NeighborhoodType::VON_NEUMANN
+                               : NeighborhoodType::MOORE,
+                           config.WRAP_EDGES() != 0);
+    world->InitializeGrid(num_w_boxes, num_h_boxes);
 
     // Initialize destruction based on selected pattern and rounds
     if (config.DESTRUCTION_ROUNDS() > 0) {
@@ -180,12 +270,9 @@ private:
       );
       destruction_initialized = true;
     } else {
-      // Immediate destruction using original methods
-      if (config.DESTRUCTION_PATTERN() == 0) {
-        world->DestroyHabitatRandom(config.PERCENT_DESTROYED());
-      } else {
-        world->DestroyHabitatGradient(config.PERCENT_DESTROYED());
-      }
+      // Immediate destruction
+      world->InitializeIncrementalDestruction(config.PERCENT_DESTROYED(), 0,
+                                              config.DESTRUCTION_PATTERN());
     }
 
     // Populate with both species
@@ -197,44 +284,36 @@ private:
   }
 
   /**
-   * @brief Add both species to occupy 25% each of available habitat
+   * @brief Add both species to occupy INITIAL_OCCUPANCY / 2 each of available habitat
    *
    * Based on the paper's specification that "each species occupies 0.25
-   * of the remaining available habitat" at initialization.
+   * of the remaining available habitat" at initialization (the default 0.5).
    */
   void PopulateWithBothSpecies() {
     // Clear existing organisms
-    for (size_t i = 0; i < world->GetSize(); i++) {
-      if (world->IsOccupied(i)) {
-        world->RemoveOrganism(i);
-      }
-    }
+    world->RemoveAllOrganisms();
 
     // Count available cells (non-destroyed habitat)
-    std::vector<size_t> available_cells;
-    for (size_t i = 0; i < world->GetSize(); i++) {
-      if (world->IsAvailable(i)) {
-        available_cells.push_back(i);
-      }
-    }
+    std::vector<size_t> available_cells = world->GetAvailableCells();
 
     // Calculate how many cells each species should occupy
-    // Each species gets 25% of available habitat
-    int cells_per_species = static_cast<int>(available_cells.size() * 0.25);
+    // Each species gets half of the initial occupancy
+    int cells_per_species =
+        static_cast<int>(available_cells.size() * config.INITIAL_OCCUPANCY() / 2);
 
     // Manually shuffle the available cells for random distribution
-    for (size_t i = available_cells.size() - 1; i > 0; i--) {
+    for (size_t i = available_cells.size(); i-- > 1;) {
       size_t j = random->GetUInt(i + 1);
       std::swap(available_cells[i], available_cells[j]);
     }
 
-    // Add species C to first 25% of shuffled available cells
+    // Add species C to the first block of shuffled available cells
     for (int i = 0; i < cells_per_species && i < available_cells.size(); i++) {
       SpeciesC *new_organism = new SpeciesC(random);
       world->AddOrgAt(new_organism, available_cells[i]);
     }
 
-    // Add species D to next 25% of shuffled available cells
+    // Add species D to the next block of shuffled available cells
     for (int i = cells_per_species;
          i < cells_per_species * 2 && i < available_cells.size(); i++) {
       SpeciesD *new_organism = new SpeciesD(random);
@@ -244,44 +323,67 @@ private:
 
   /**
    * @brief Render the current state of the world
+   *
+   * Only cells that changed since the last frame are written to the pixel
+   * buffer, and only the rows holding them are copied to the browser.  The
+   * whole frame is then one ImageData put and one scaled drawImage instead
+   * of a canvas call per cell.
    */
   void DrawWorld() {
-    canvas.Clear();
-
-    for (int x = 0; x < NUM_W_BOXES; x++) {
-      for (int y = 0; y < NUM_H_BOXES; y++) {
-        size_t pos = y * NUM_W_BOXES + x;
-        std::string color = GetCellColor(pos);
-        DrawCell(x, y, color);
-      }
-    }
-  }
-
-  /**
-   * @brief Draw a single cell on the canvas
-   * @param x X coordinate in grid
-   * @param y Y coordinate in grid
-   * @param color Fill color for the cell
-   */
-  void DrawCell(int x, int y, const std::string &color) {
-    canvas.Rect(x * RECT_SIDE, y * RECT_SIDE, RECT_SIDE, RECT_SIDE, color,
-                "black");
+    image.Update(*world);
+    int first_row = 0, num_rows = 0;
+    image.GetDirtyRows(first_row, num_rows);
+    if (num_rows == 0)
+      return;
+    BlitImage(first_row, num_rows);
+    image.ClearDirty();
   }
 
   /**
-   * @brief Get the color for a cell based on its contents
-   * @param pos Position in the world grid
-   * @return Color string for the cell
+   * @brief Copy rows of the pixel buffer to the page and redraw the canvas
+   * @param first_row First row to copy
+   * @param num_rows Number of rows to copy
+   *
+   * The rows go to an offscreen canvas of one pixel per cell, which is then
+   * scaled onto the visible canvas without smoothing.  Cells of at least
+   * GRID_LINE_SIDE pixels get black outlines, drawn as a single path.
    */
-  std::string GetCellColor(size_t pos) {
-    if (world->IsDestroyed(pos)) {
-      return destroyed_color;
-    } else if (!world->IsOccupied(pos)) {
-      return empty_color;
-    } else {
-      int species = world->GetOrg(pos).GetSpecies();
-      return (species == 0) ? species_c_color : species_d_color;
-    }
+  void BlitImage(int first_row, int num_rows) {
+    EM_ASM(
+        {
+          var width = $2;
+          var height = $3;
+          var cells = Module.cellImage;
+          if (!cells || cells.width != width || cells.height != height) {
+            cells = document.createElement('canvas');
+            cells.width = width;
+            cells.height = height;
+            Module.cellImage = cells;
+          }
+          var rows = new Uint8ClampedArray(HEAPU8.buffer, $1 + $4 * width * 4, $5 * width * 4);
+          cells.getContext('2d').putImageData(new ImageData(rows, width, $5), 0, $4);
+
+          var canvas = document.getElementById(UTF8ToString($0));
+          var ctx = canvas.getContext('2d');
+          ctx.imageSmoothingEnabled = false;
+          ctx.drawImage(cells, 0, 0, canvas.width, canvas.height);
+          var side = $6;
+          if (side >= $7) {
+            ctx.beginPath();
+            for (var x = 0; x <= width; x++) {
+              ctx.moveTo(x * side, 0);
+              ctx.lineTo(x * side, height * side);
+            }
+            for (var y = 0; y <= height; y++) {
+              ctx.moveTo(0, y * side);
+              ctx.lineTo(width * side, y * side);
+            }
+            ctx.strokeStyle = 'black';
+            ctx.stroke();
+          }
+        },
+        canvas.GetID().c_str(), image.GetData(), image.GetWidth(), image.GetHeight(),
+        first_row, num_rows, rect_side, GRID_LINE_SIDE);
   }
 
   /**
@@ -289,6 +391,10 @@ private:
    */
   void UpdateStats() {
     auto counts = world->CountCells();
+    if (round_count == shown_round && counts == shown_counts)
+      return;
+    shown_round = round_count;
+    shown_counts = counts;
     stats_div.Clear();
     stats_div << "<b>Round:</b> " << round_count << " | ";
     stats_div << "<b>Cell Counts:</b> ";
@@ -299,7 +405,7 @@ private:
     stats_div << "Proportion habitable: " << (1.0 - config.PERCENT_DESTROYED())
               << " | ";
     stats_div << "Pattern: "
-              << (config.DESTRUCTION_PATTERN() == 0 ? "Random" : "Gradient");
+              << LandscapePatternName(config.DESTRUCTION_PATTERN());
   }
 };
 